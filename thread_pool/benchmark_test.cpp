@@ -0,0 +1,581 @@
+/*
+ * benchmark_test.cpp
+ *
+ * Benchmarking the published Thread_Pool variants over a matrix of settings,
+ * the tables once filled in by hand from the output of test.sh.
+ *   - every cell is a variant, an idle policy, a number of producers, a
+ *     number of workers, how they are pinned to CPUs, a task kernel and
+ *     either an inter-arrival delay for closed-loop producers, which submit
+ *     as fast as the pool takes, or an offered rate of open-loop ones,
+ *     which submit on a schedule of schedule.h
+ *   - every cell runs some warm-up rounds, which are thrown away, and then
+ *     the measured repetitions
+ *   - a cell reports the mean, standard deviation and 95% confidence
+ *     interval of submit and completion throughput and of the CPU busy,
+ *     in cores from the start to the pool having stopped, as CSV or JSON,
+ *     and with --latency yes the p50, p99, p99.9 and max in nanoseconds of
+ *     the task latencies of latency.h over all its measured rounds
+ *   - latencies against offered rate make the curve of a variant, whose
+ *     knee shows where it saturates, and latencies against CPU across idle
+ *     policies the trade-off of spinning
+ *
+ * Options, lists being comma separated:
+ *   --variants  names        default all, see VARIANTS
+ *   --idles     names        default own, the idle policy of the variant,
+ *                            or park or adaptive instead, see idle.h
+ *   --producers counts       default 10, as in the other harnesses
+ *   --workers   counts       default 0, for one a CPU of the affinity, or
+ *                            thread::hardware_concurrency() unpinned; the
+ *                            output has the count the pool resolved
+ *   --affinities modes       default none,cores, i.e. without pinning and
+ *                            with a worker on every physical core, see
+ *                            topology.h
+ *   --kernels   names        default spin:1000, see workload.h, or arrow
+ *                            for the stdout-printing shoot() of archery.h
+ *   --delays    microseconds default 0, a producer sleeps a random time
+ *                            below the delay between submissions, or
+ *                            yields if it is 0
+ *   --rates     tasks/second none by default, otherwise producers are open
+ *                            loop and share a Poisson schedule of each rate
+ *   --trace     path         instead of --rates, a schedule of send offsets
+ *                            in nanoseconds, one a line, in any order
+ *   --period    seconds      default 1, of submitting in every round
+ *   --warmup    rounds       default 1
+ *   --repeat    rounds       default 5
+ *   --latency   yes or no    default no, recording latencies costs two
+ *                            clock readings a task; always yes open loop
+ *   --format    csv or json  default csv
+ *   --output    path         default stderr, as arrow prints to stdout
+ *
+ */
+
+#include <sys/resource.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "archery.h"
+#include "blocking_overflow_blocking_unique_pool.h"
+#include "blocking_overflow_lockwise_mutual_pool.h"
+#include "blocking_shared_blocking_unique_pool.h"
+#include "blocking_shared_lockwise_mutual_2b_pool.h"
+#include "blocking_shared_lockwise_mutual_pool.h"
+#include "blocking_shared_pool.h"
+#include "blocking_unique_pool.h"
+#include "futex_unique_pool.h"
+#include "latency.h"
+#include "lockfree_mutual_pool.h"
+#include "lockfree_shared_pool.h"
+#include "lockwise_mutual_2a_pool.h"
+#include "lockwise_mutual_2b_pool.h"
+#include "lockwise_mutual_2c_pool.h"
+#include "lockwise_mutual_2d_pool.h"
+#include "lockwise_mutual_2e_pool.h"
+#include "lockwise_mutual_pool.h"
+#include "lockwise_shared_pool.h"
+#include "lockwise_unique_pool.h"
+#include "pool_config.h"
+#include "schedule.h"
+#include "workload.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::string;
+using std::thread;
+using std::vector;
+
+
+void arrow_kernel(uint64_t) {
+    shoot();
+}
+
+
+struct Kernel {
+    string _name_;
+    Workload _workload_;
+};
+
+
+struct Pinning {
+    string _name_;
+    Affinity _affinity_;
+};
+
+
+struct Setting {
+    unsigned _producers_;
+    unsigned _workers_;
+    Pinning const* _pinning_;
+    Kernel const* _kernel_;
+    unsigned _delay_;
+    double _period_;
+    vector<uint64_t> const* _schedule_;     // null for closed loop
+};
+
+
+struct Sample {
+    double _submitrate_;
+    double _completerate_;
+    double _cpu_;
+    unsigned _workers_;     // as the pool resolved Setting::_workers_
+};
+
+
+// user and system time of the process in seconds
+double cpu_time() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+         + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+
+// submits as fast as the pool takes, for the period
+template<class Pool>
+size_t close_loop(Pool& pool, Setting const& setting, unsigned index, time_point<steady_clock> start) {
+    duration<double> PERIOD(setting._period_);
+    std::minstd_rand random(index + 1);
+    Workload workload = setting._kernel_->_workload_;
+    size_t n = 0;
+    for (; steady_clock::now() - start <= PERIOD; ++n) {
+        pool.post([workload] { workload(); });
+        if (setting._delay_)
+            std::this_thread::sleep_for(microseconds(random() % setting._delay_));
+        else
+            std::this_thread::yield();
+    }
+    return n;
+}
+
+
+// submits every producersize-th task of the schedule from the index-th on,
+// when it is due or, if late, at once
+template<class Pool>
+size_t open_loop(Pool& pool, Setting const& setting, unsigned index, time_point<steady_clock> start) {
+    uint64_t startns = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+    vector<uint64_t> const& schedule = *setting._schedule_;
+    Workload workload = setting._kernel_->_workload_;
+    size_t n = 0;
+    for (size_t k = index; k < schedule.size(); k += setting._producers_, ++n) {
+        uint64_t due = startns + schedule[k];
+        wait_until(due);
+        pool.post_at(due, [workload] { workload(); });
+    }
+    return n;
+}
+
+
+// completion counts from the start until the pool has drained and stopped
+template<class Pool>
+Sample run(Setting const& setting, Task_Latency* latency) {
+    duration<double> PERIOD(setting._period_);
+    vector<size_t> counter(setting._producers_, 0);
+    vector<thread> producers;
+    time_point<steady_clock> start;
+    double cpustart = 0;
+    unsigned workers = 0;
+    atomic<bool> go(false);
+
+    {
+        Pool_Config config;
+        config._workersize_ = setting._workers_;
+        config._affinity_ = setting._pinning_->_affinity_;
+        config._latency_ = latency;
+        Pool pool(config);
+        workers = pool.workersize();
+
+        for (unsigned i = 0; i < setting._producers_; ++i) {
+            producers.emplace_back([i, &setting, &counter, &start, &go, &pool] {
+                while (!go.load(memory_order_acquire))
+                    std::this_thread::yield();
+                counter[i] = setting._schedule_ ? open_loop(pool, setting, i, start)
+                                                : close_loop(pool, setting, i, start);
+            });
+        }
+
+        std::this_thread::sleep_for(milliseconds(100));
+        start = steady_clock::now();
+        cpustart = cpu_time();
+        go.store(true, memory_order_release);
+        for (thread& t : producers)
+            t.join();
+    }
+
+    time_point<steady_clock> end = steady_clock::now();
+    double took = duration<double>(end - start).count();
+    double cpu = cpu_time() - cpustart;
+    size_t total = 0;
+    for (size_t n : counter)
+        total += n;
+    return {total / PERIOD.count(), total / took, cpu / took, workers};
+}
+
+
+char const* const IDLE_NAMES[] = {"own", "park", "adaptive"};
+
+
+// a run of the pool for every one of IDLE_NAMES
+struct Variant {
+    char const* _name_;
+    Sample (*_runs_[3])(Setting const&, Task_Latency*);
+};
+
+
+template<class Pool>
+constexpr Variant variant(char const* name) {
+    return {name, {run<Pool>,
+                   run<typename With_Idle<Pool, Park_Idle>::Type>,
+                   run<typename With_Idle<Pool, Adaptive_Idle>::Type>}};
+}
+
+
+Variant const VARIANTS[] = {
+    variant<Lockwise_Shared_Pool>("lockwise_shared"),
+    variant<Lockfree_Shared_Pool>("lockfree_shared"),
+    variant<Blocking_Shared_Pool>("blocking_shared"),
+    variant<Lockwise_Unique_Pool<>>("lockwise_unique"),
+    variant<Blocking_Unique_Pool<>>("blocking_unique"),
+    variant<Futex_Unique_Pool<>>("futex_unique"),
+    variant<Lockwise_Mutual_Pool<>>("lockwise_mutual"),
+    variant<Lockwise_Mutual_2a_Pool<>>("lockwise_mutual_2a"),
+    variant<Lockwise_Mutual_2b_Pool<>>("lockwise_mutual_2b"),
+    variant<Lockwise_Mutual_2c_Pool<>>("lockwise_mutual_2c"),
+    variant<Lockwise_Mutual_2d_Pool<>>("lockwise_mutual_2d"),
+    variant<Lockwise_Mutual_2e_Pool<>>("lockwise_mutual_2e"),
+    variant<Lockfree_Mutual_Pool<>>("lockfree_mutual"),
+    variant<Blocking_Shared_Blocking_Unique_Pool<>>("blocking_shared_blocking_unique"),
+    variant<Blocking_Shared_Lockwise_Mutual_Pool<>>("blocking_shared_lockwise_mutual"),
+    variant<Blocking_Shared_Lockwise_Mutual_2b_Pool<>>("blocking_shared_lockwise_mutual_2b"),
+    variant<Blocking_Overflow_Blocking_Unique_Pool<>>("blocking_overflow_blocking_unique"),
+    variant<Blocking_Overflow_Lockwise_Mutual_Pool<>>("blocking_overflow_lockwise_mutual"),
+};
+
+
+struct Summary {
+    double _mean_;
+    double _stddev_;
+    double _ci95_;      // half width
+};
+
+
+// two-sided 95% quantiles of Student's t, by degrees of freedom
+double t95(size_t df) {
+    static double const QUANTILES[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    return df < sizeof(QUANTILES) / sizeof(QUANTILES[0]) ? QUANTILES[df] : 1.960;
+}
+
+
+Summary summarize(vector<double> const& xs) {
+    size_t n = xs.size();
+    double mean = 0;
+    for (double x : xs)
+        mean += x;
+    mean /= n;
+    if (n < 2)
+        return {mean, 0, 0};
+    double var = 0;
+    for (double x : xs)
+        var += (x - mean) * (x - mean);
+    double stddev = std::sqrt(var / (n - 1));
+    return {mean, stddev, t95(n - 1) * stddev / std::sqrt(static_cast<double>(n))};
+}
+
+
+struct Options {
+    vector<Variant const*> _variants_;
+    vector<unsigned> _idles_{0};
+    vector<unsigned> _producers_{10};
+    vector<unsigned> _workers_{0};
+    vector<Pinning> _pinnings_;
+    vector<Kernel> _kernels_;
+    vector<unsigned> _delays_{0};
+    vector<double> _rates_;
+    char const* _trace_ = nullptr;
+    double _period_ = 1;
+    unsigned _warmup_ = 1;
+    unsigned _repeat_ = 5;
+    bool _latency_ = false;
+    bool _json_ = false;
+    char const* _output_ = nullptr;
+};
+
+
+vector<string> split(char const* list) {
+    vector<string> items;
+    string item;
+    for (char const* p = list; ; ++p) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty())
+                items.push_back(item);
+            item.clear();
+            if (*p == '\0')
+                return items;
+        } else {
+            item += *p;
+        }
+    }
+}
+
+
+vector<unsigned> split_counts(char const* list) {
+    vector<unsigned> counts;
+    for (string const& item : split(list))
+        counts.push_back(std::strtoul(item.c_str(), nullptr, 10));
+    return counts;
+}
+
+
+Kernel parse_kernel(string const& spec) {
+    Kernel k = {spec, {arrow_kernel, 0}};
+    if (spec != "arrow" && !parse_workload(spec.c_str(), k._workload_)) {
+        std::fprintf(stderr, "Unknown kernel: %s\n", spec.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    return k;
+}
+
+
+Pinning parse_pinning(string const& spec) {
+    Pinning p = {spec, Affinity()};
+    if (!parse_affinity(spec.c_str(), p._affinity_)) {
+        std::fprintf(stderr, "Unknown affinity: %s\n", spec.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+
+template<class Entry, size_t N>
+Entry const* find(Entry const (&entries)[N], string const& name) {
+    for (Entry const& e : entries)
+        if (name == e._name_)
+            return &e;
+    std::fprintf(stderr, "Unknown name: %s\n", name.c_str());
+    std::exit(EXIT_FAILURE);
+}
+
+
+unsigned find_idle(string const& name) {
+    for (unsigned i = 0; i < 3; ++i)
+        if (name == IDLE_NAMES[i])
+            return i;
+    std::fprintf(stderr, "Unknown idle policy: %s\n", name.c_str());
+    std::exit(EXIT_FAILURE);
+}
+
+
+Options parse(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 == argc) {
+            std::fprintf(stderr, "Missing value of %s\n", argv[i]);
+            std::exit(EXIT_FAILURE);
+        }
+        char const* value = argv[i + 1];
+        if (!std::strcmp(argv[i], "--variants")) {
+            for (string const& name : split(value))
+                options._variants_.push_back(find(VARIANTS, name));
+        } else if (!std::strcmp(argv[i], "--idles")) {
+            options._idles_.clear();
+            for (string const& name : split(value))
+                options._idles_.push_back(find_idle(name));
+        } else if (!std::strcmp(argv[i], "--producers")) {
+            options._producers_ = split_counts(value);
+        } else if (!std::strcmp(argv[i], "--workers")) {
+            options._workers_ = split_counts(value);
+        } else if (!std::strcmp(argv[i], "--affinities")) {
+            for (string const& spec : split(value))
+                options._pinnings_.push_back(parse_pinning(spec));
+        } else if (!std::strcmp(argv[i], "--kernels")) {
+            for (string const& spec : split(value))
+                options._kernels_.push_back(parse_kernel(spec));
+        } else if (!std::strcmp(argv[i], "--delays")) {
+            options._delays_ = split_counts(value);
+        } else if (!std::strcmp(argv[i], "--rates")) {
+            for (string const& item : split(value))
+                options._rates_.push_back(std::strtod(item.c_str(), nullptr));
+        } else if (!std::strcmp(argv[i], "--trace")) {
+            options._trace_ = value;
+        } else if (!std::strcmp(argv[i], "--period")) {
+            options._period_ = std::strtod(value, nullptr);
+        } else if (!std::strcmp(argv[i], "--warmup")) {
+            options._warmup_ = std::strtoul(value, nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--repeat")) {
+            options._repeat_ = std::max(std::strtoul(value, nullptr, 10), 1ul);
+        } else if (!std::strcmp(argv[i], "--latency")) {
+            options._latency_ = !std::strcmp(value, "yes");
+        } else if (!std::strcmp(argv[i], "--format")) {
+            options._json_ = !std::strcmp(value, "json");
+        } else if (!std::strcmp(argv[i], "--output")) {
+            options._output_ = value;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (options._variants_.empty())
+        for (Variant const& v : VARIANTS)
+            options._variants_.push_back(&v);
+    if (options._pinnings_.empty()) {
+        options._pinnings_.push_back(parse_pinning("none"));
+        options._pinnings_.push_back(parse_pinning("cores"));
+    }
+    if (options._kernels_.empty())
+        options._kernels_.push_back(parse_kernel("spin:1000"));
+    if (!options._rates_.empty() && options._trace_) {
+        std::fprintf(stderr, "Either --rates or --trace, not both\n");
+        std::exit(EXIT_FAILURE);
+    }
+    if (!options._rates_.empty() || options._trace_) {
+        if (options._delays_.size() != 1 || options._delays_[0]) {
+            std::fprintf(stderr, "Open-loop producers take no --delays\n");
+            std::exit(EXIT_FAILURE);
+        }
+        if (options._rates_.empty())
+            options._rates_.push_back(0);
+        options._latency_ = true;
+    } else {
+        options._rates_.push_back(0);
+    }
+    return options;
+}
+
+
+char const* const LATENCY_NAMES[] = {"queueing", "execution", "endtoend"};
+
+
+void print_latency(FILE* out, Task_Latency const& latency, bool json) {
+    Latency_Histogram const* histograms[] = {&latency._queueing_, &latency._execution_, &latency._endtoend_};
+    for (unsigned i = 0; i < 3; ++i) {
+        Latency_Histogram const& h = *histograms[i];
+        unsigned long long p50 = h.percentile(0.5);
+        unsigned long long p99 = h.percentile(0.99);
+        unsigned long long p999 = h.percentile(0.999);
+        unsigned long long max = h.max();
+        if (json)
+            std::fprintf(out, ",\n   \"%s_ns\": {\"p50\": %llu, \"p99\": %llu, \"p99.9\": %llu, \"max\": %llu}",
+                         LATENCY_NAMES[i], p50, p99, p999, max);
+        else
+            std::fprintf(out, ",%llu,%llu,%llu,%llu", p50, p99, p999, max);
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    Options options = parse(argc, argv);
+    FILE* out = options._output_ ? std::fopen(options._output_, "w") : stderr;
+    if (!out) {
+        std::perror(options._output_);
+        return EXIT_FAILURE;
+    }
+
+    if (options._json_) {
+        std::fprintf(out, "[");
+    } else {
+        std::fprintf(out, "variant,idle,producers,workers,affinity,kernel,delay_us,rate,repeat,"
+                          "submit_mean,submit_stddev,submit_ci95,"
+                          "complete_mean,complete_stddev,complete_ci95,"
+                          "cpu_mean,cpu_stddev,cpu_ci95");
+        for (unsigned i = 0; options._latency_ && i < 3; ++i)
+            std::fprintf(out, ",%s_p50_ns,%s_p99_ns,%s_p999_ns,%s_max_ns", LATENCY_NAMES[i],
+                         LATENCY_NAMES[i], LATENCY_NAMES[i], LATENCY_NAMES[i]);
+        std::fprintf(out, "\n");
+    }
+    bool first = true;
+
+    vector<uint64_t> trace;
+    if (options._trace_) {
+        trace = read_schedule(options._trace_);
+        if (trace.empty()) {
+            std::fprintf(stderr, "Empty or unreadable trace: %s\n", options._trace_);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (Variant const* variant : options._variants_)
+    for (unsigned idle : options._idles_)
+    for (unsigned producers : options._producers_)
+    for (unsigned workers : options._workers_)
+    for (Pinning const& pinning : options._pinnings_)
+    for (Kernel const& kernel : options._kernels_)
+    for (unsigned delay : options._delays_)
+    for (double rate : options._rates_) {
+        prepare_workload(kernel._workload_);
+        Setting setting = {producers, workers, &pinning, &kernel, delay, options._period_, nullptr};
+        vector<uint64_t> schedule;
+        if (options._trace_) {
+            schedule = trace;
+            setting._period_ = std::max(schedule.back() / 1e9, 1e-3);
+            rate = schedule.size() / setting._period_;
+        } else if (rate) {
+            schedule = poisson_schedule(rate, setting._period_, 1);
+        }
+        if (options._trace_ || rate)
+            setting._schedule_ = &schedule;
+        vector<double> submitrates;
+        vector<double> completerates;
+        vector<double> cpus;
+        unsigned resolved = workers;
+        Task_Latency* latency = options._latency_ ? new Task_Latency() : nullptr;
+        for (unsigned i = 0; i < options._warmup_ + options._repeat_; ++i) {
+            Sample sample = variant->_runs_[idle](setting, i < options._warmup_ ? nullptr : latency);
+            if (i < options._warmup_)
+                continue;
+            submitrates.push_back(sample._submitrate_);
+            completerates.push_back(sample._completerate_);
+            cpus.push_back(sample._cpu_);
+            resolved = sample._workers_;
+        }
+        Summary submit = summarize(submitrates);
+        Summary complete = summarize(completerates);
+        Summary cpu = summarize(cpus);
+
+        if (options._json_)
+            std::fprintf(out, "%s\n  {\"variant\": \"%s\", \"idle\": \"%s\", \"producers\": %u, \"workers\": %u, "
+                              "\"affinity\": \"%s\", \"kernel\": \"%s\", \"delay_us\": %u, \"rate\": %.1f, \"repeat\": %u,\n"
+                              "   \"submit\": {\"mean\": %.1f, \"stddev\": %.1f, \"ci95\": %.1f},\n"
+                              "   \"complete\": {\"mean\": %.1f, \"stddev\": %.1f, \"ci95\": %.1f},\n"
+                              "   \"cpu\": {\"mean\": %.3f, \"stddev\": %.3f, \"ci95\": %.3f}",
+                         first ? "" : ",", variant->_name_, IDLE_NAMES[idle], producers, resolved,
+                         pinning._name_.c_str(), kernel._name_.c_str(), delay,
+                         rate, options._repeat_, submit._mean_, submit._stddev_, submit._ci95_,
+                         complete._mean_, complete._stddev_, complete._ci95_, cpu._mean_, cpu._stddev_, cpu._ci95_);
+        else
+            std::fprintf(out, "%s,%s,%u,%u,%s,%s,%u,%.1f,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f",
+                         variant->_name_, IDLE_NAMES[idle], producers, resolved, pinning._name_.c_str(),
+                         kernel._name_.c_str(), delay,
+                         rate, options._repeat_, submit._mean_, submit._stddev_, submit._ci95_,
+                         complete._mean_, complete._stddev_, complete._ci95_, cpu._mean_, cpu._stddev_, cpu._ci95_);
+        if (latency)
+            print_latency(out, *latency, options._json_);
+        std::fprintf(out, options._json_ ? "}" : "\n");
+        std::fflush(out);
+        delete latency;
+        first = false;
+    }
+
+    if (options._json_)
+        std::fprintf(out, "\n]\n");
+    if (out != stderr)
+        std::fclose(out);
+    return 0;
+}
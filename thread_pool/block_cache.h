@@ -0,0 +1,148 @@
+/*
+ * block_cache.h
+ *
+ * Recycling memory blocks of one size without going back to malloc/free.
+ *   - every thread owns a cache, blocks it allocates remember the cache
+ *   - a block freed by its owner thread goes back to the owner's local list
+ *   - a block freed by another thread is pushed onto the owner's remote
+ *     list, a lock-free stack which only the owner takes as a whole
+ *   - the cache of an exited thread is handed over to the next new thread
+ *
+ * So tasks allocated by a submitter and freed by a worker come back to the
+ * submitter, and a cache holds no more blocks than its owner ever had alive
+ * at once.  Blocks are never returned to the system.
+ *
+ */
+
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+
+#include <cstddef>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "cache_line.h"
+
+
+using std::atomic;
+using std::lock_guard;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::mutex;
+using std::vector;
+
+
+template<size_t Size>
+class Block_Cache {
+
+  private:
+    struct Header {
+        Block_Cache* _owner_;
+        Header* _next_;
+    };
+
+    static constexpr size_t HEADER_SIZE =
+        (sizeof(Header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    // the owner alone touches the local list, other threads the remote one
+    Header* _local_;
+    alignas(CACHE_LINE_SIZE) atomic<Header*> _remote_;
+
+    Block_Cache() : _local_(nullptr), _remote_(nullptr) {}
+
+    static mutex& orphans_mutex() {
+        static mutex* m = new mutex;
+        return *m;
+    }
+
+    // never destructed, exiting threads may still hand over their caches
+    static vector<Block_Cache*>& orphans() {
+        static vector<Block_Cache*>* v = new vector<Block_Cache*>;
+        return *v;
+    }
+
+    // binds a cache to the current thread from its first allocation on
+    struct Binding {
+        Block_Cache* _cache_;
+        Binding() {
+            lock_guard<mutex> lk(orphans_mutex());
+            if (orphans().empty()) {
+                _cache_ = new Block_Cache;
+            } else {
+                _cache_ = orphans().back();
+                orphans().pop_back();
+            }
+            current() = _cache_;
+        }
+        ~Binding() {
+            current() = nullptr;
+            exited() = true;
+            lock_guard<mutex> lk(orphans_mutex());
+            orphans().push_back(_cache_);
+        }
+    };
+
+    static Block_Cache*& current() {
+        thread_local Block_Cache* c = nullptr;
+        return c;
+    }
+
+    static bool& exited() {
+        thread_local bool e = false;
+        return e;
+    }
+
+    static Block_Cache* local() {
+        if (current() || exited())
+            return current();
+        thread_local Binding binding;
+        return binding._cache_;
+    }
+
+  public:
+    static void* allocate() {
+        Block_Cache* c = local();
+        Header* h = nullptr;
+        if (c) {
+            if (!c->_local_)
+                c->_local_ = c->_remote_.exchange(nullptr, memory_order_acquire);
+            h = c->_local_;
+            if (h)
+                c->_local_ = h->_next_;
+        }
+        if (!h) {
+            h = static_cast<Header*>(::operator new(HEADER_SIZE + Size));
+            h->_owner_ = c;
+        }
+        return reinterpret_cast<char*>(h) + HEADER_SIZE;
+    }
+
+    static void deallocate(void* p) {
+        Header* h = reinterpret_cast<Header*>(static_cast<char*>(p) - HEADER_SIZE);
+        Block_Cache* owner = h->_owner_;
+        if (!owner) {
+            ::operator delete(h);
+        } else if (owner == current()) {
+            h->_next_ = owner->_local_;
+            owner->_local_ = h;
+        } else {
+            h->_next_ = owner->_remote_.load(memory_order_relaxed);
+            while (!owner->_remote_.compare_exchange_weak(h->_next_, h, memory_order_release, memory_order_relaxed));
+        }
+    }
+
+};
+
+
+// blocks come in multiples of a cache line
+constexpr size_t block_size(size_t n) {
+    return (n + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+
+#endif
@@ -0,0 +1,30 @@
+/*
+ * blocking_overflow_blocking_unique_pool.h
+ *
+ * A simple thread pool accepting callables as tasks and using:
+ *   - several unique task queues within each worker thread, which
+ *     submitters put tasks into while they are short
+ *   - a pool task queue saving the tasks overflowing them
+ *   - a scheduler thread assigning tasks in pool queue to worker queues
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_OVERFLOW_BLOCKING_UNIQUE_POOL_H
+#define BLOCKING_OVERFLOW_BLOCKING_UNIQUE_POOL_H
+
+
+#include "blocking_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Blocking_Overflow_Blocking_Unique_Pool = Thread_Pool<Worker_Queues<Blocking_Queue<Task_Wrapper>>,
+                                                           Placement,
+                                                           No_Steal,
+                                                           Block_Idle,
+                                                           Overflow_Front>;
+
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * blocking_overflow_lockwise_mutual_pool.h
+ *
+ * A simple thread pool accepting callables as tasks and using:
+ *   - several mutual task queues within worker threads, which submitters
+ *     put tasks into while they are short
+ *   - a pool task queue saving the tasks overflowing them
+ *   - a scheduler thread assigning tasks in pool queue to worker queues
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_OVERFLOW_LOCKWISE_MUTUAL_POOL_H
+#define BLOCKING_OVERFLOW_LOCKWISE_MUTUAL_POOL_H
+
+
+#include "lockwise_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Blocking_Overflow_Lockwise_Mutual_Pool = Thread_Pool<Worker_Queues<Lockwise_Queue<Task_Wrapper>>,
+                                                           Placement,
+                                                           Steal<Front_End, Front_End>,
+                                                           Park_Idle,
+                                                           Overflow_Front>;
+
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * blocking_queue.h
+ *
+ * A generic queue supporting concurrency access.
+ *   - blocking
+ *   - using std::mutex with condition_variable
+ *   - element type is movable
+ *
+ * Consumers count themselves while they wait, so a push wakes nobody if
+ * nobody sleeps, and notifies after the lock is released, so the woken
+ * thread does not block on it at once.
+ *
+ * Besides the blocking pop(), try_pop() and try_pop_bulk() do not wait and
+ * pop_for() and pop_until() wait no longer than a timeout.  close() wakes
+ * every waiter; the elements left are still popped, and after them every
+ * pop returns CLOSED, or false or 0, at once.
+ *
+ */
+
+#ifndef BLOCKING_QUEUE_H
+#define BLOCKING_QUEUE_H
+
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+
+
+using std::condition_variable;
+using std::lock_guard;
+using std::mutex;
+using std::queue;
+using std::unique_lock;
+
+
+enum class Pop_Status { POPPED, EMPTY, TIMEOUT, CLOSED };
+
+
+template<class T>
+class Blocking_Queue {
+
+  private:
+    mutex mutable _m_;
+    condition_variable _cv_;
+    queue<T> _q_;
+    size_t _waiters_ = 0;
+    bool _closed_ = false;
+
+    bool ready() const {
+        return !_q_.empty() || _closed_;
+    }
+
+    // under the lock
+    void wait(unique_lock<mutex>& lk) {
+        ++_waiters_;
+        _cv_.wait(lk, [this]{ return ready(); });
+        --_waiters_;
+    }
+
+    template<class Clock, class Duration>
+    void wait_until(unique_lock<mutex>& lk, std::chrono::time_point<Clock, Duration> const& deadline) {
+        ++_waiters_;
+        _cv_.wait_until(lk, deadline, [this]{ return ready(); });
+        --_waiters_;
+    }
+
+    // after the lock, no more than one waiter for each element
+    void wake(size_t waiters, size_t n) {
+        if (n >= waiters) {
+            if (waiters > 1)
+                _cv_.notify_all();
+            else if (waiters == 1)
+                _cv_.notify_one();
+        } else {
+            for (size_t i = 0; i < n; ++i)
+                _cv_.notify_one();
+        }
+    }
+
+    // under the lock, after waiting
+    Pop_Status take(T& element, Pop_Status otherwise) {
+        if (_q_.empty())
+            return _closed_ ? Pop_Status::CLOSED : otherwise;
+        element = std::move(_q_.front());
+        _q_.pop();
+        return Pop_Status::POPPED;
+    }
+
+  public:
+    void push(T&& element) {
+        unique_lock<mutex> lk(_m_);
+        _q_.push(std::move(element));
+        size_t waiters = _waiters_;
+        lk.unlock();
+        if (waiters)
+            _cv_.notify_one();
+    }
+
+    // n elements moved in under one lock, waking as many waiters
+    void push_bulk(T* elements, size_t n) {
+        unique_lock<mutex> lk(_m_);
+        for (size_t i = 0; i < n; ++i)
+            _q_.push(std::move(elements[i]));
+        size_t waiters = _waiters_;
+        lk.unlock();
+        wake(waiters, n);
+    }
+
+    // false once closed and drained
+    bool pop(T& element) {
+        unique_lock<mutex> lk(_m_);
+        if (!ready())
+            wait(lk);
+        return take(element, Pop_Status::CLOSED) == Pop_Status::POPPED;
+    }
+
+    // waits for one element at least, then moves out no more than max
+    // elements under one lock, returns how many, 0 once closed and drained
+    size_t pop_bulk(T* elements, size_t max) {
+        unique_lock<mutex> lk(_m_);
+        if (!ready())
+            wait(lk);
+        size_t n = 0;
+        for (; n < max && !_q_.empty(); ++n) {
+            elements[n] = std::move(_q_.front());
+            _q_.pop();
+        }
+        return n;
+    }
+
+    Pop_Status try_pop(T& element) {
+        lock_guard<mutex> lk(_m_);
+        return take(element, Pop_Status::EMPTY);
+    }
+
+    // no more than max elements, without waiting, returns how many
+    size_t try_pop_bulk(T* elements, size_t max) {
+        lock_guard<mutex> lk(_m_);
+        size_t n = 0;
+        for (; n < max && !_q_.empty(); ++n) {
+            elements[n] = std::move(_q_.front());
+            _q_.pop();
+        }
+        return n;
+    }
+
+    template<class Clock, class Duration>
+    Pop_Status pop_until(T& element, std::chrono::time_point<Clock, Duration> const& deadline) {
+        unique_lock<mutex> lk(_m_);
+        if (!ready())
+            wait_until(lk, deadline);
+        return take(element, Pop_Status::TIMEOUT);
+    }
+
+    template<class Rep, class Period>
+    Pop_Status pop_for(T& element, std::chrono::duration<Rep, Period> const& timeout) {
+        return pop_until(element, std::chrono::steady_clock::now() + timeout);
+    }
+
+    // wakes every waiter, once
+    void close() {
+        unique_lock<mutex> lk(_m_);
+        _closed_ = true;
+        size_t waiters = _waiters_;
+        lk.unlock();
+        if (waiters)
+            _cv_.notify_all();
+    }
+
+    bool closed() const {
+        lock_guard<mutex> lk(_m_);
+        return _closed_;
+    }
+
+    bool empty() const {
+        lock_guard<mutex> lk(_m_);
+        return _q_.empty();
+    }
+
+    size_t size() const {
+        lock_guard<mutex> lk(_m_);
+        return _q_.size();
+    }
+
+};
+
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * blocking_queue_test.cpp
+ *
+ * Testing the non-blocking and timed pops of Blocking_Queue, and how
+ * close() wakes its waiters and lets them drain it.
+ *
+ */
+
+#include <cstdio>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "blocking_queue.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::thread;
+using std::vector;
+
+
+char const* const STATUS_NAMES[] = {"popped", "empty", "timeout", "closed"};
+
+
+void check(char const* what, bool ok) {
+    std::fprintf(stderr, "[%s] %s\n", ok ? "ok" : "FAILED", what);
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    Blocking_Queue<int> q;
+    int x = 0;
+
+    check("try_pop of an empty queue", q.try_pop(x) == Pop_Status::EMPTY);
+    q.push(1);
+    check("try_pop of an element", q.try_pop(x) == Pop_Status::POPPED && x == 1);
+
+    time_point<steady_clock> start = steady_clock::now();
+    Pop_Status s = q.pop_for(x, milliseconds(20));
+    double waited = duration<double, std::milli>(steady_clock::now() - start).count();
+    std::fprintf(stderr, "pop_for 20 ms: %s after %.3f ms\n", STATUS_NAMES[static_cast<int>(s)], waited);
+    check("pop_for times out", s == Pop_Status::TIMEOUT && waited >= 20);
+
+    thread pusher([&q] {
+        std::this_thread::sleep_for(milliseconds(5));
+        q.push(2);
+    });
+    s = q.pop_until(x, steady_clock::now() + milliseconds(1000));
+    pusher.join();
+    check("pop_until an element pushed meanwhile", s == Pop_Status::POPPED && x == 2);
+
+    // waiters blocked in every kind of pop, woken by one close()
+    unsigned const WAITERS = 8;
+    atomic<unsigned> woken(0);
+    vector<thread> waiters;
+    for (unsigned i = 0; i < WAITERS; ++i) {
+        waiters.emplace_back([i, &q, &woken] {
+            int y;
+            bool closed = false;
+            switch (i % 3) {
+              case 0:
+                closed = !q.pop(y);
+                break;
+              case 1:
+                closed = !q.pop_bulk(&y, 1);
+                break;
+              default:
+                closed = q.pop_for(y, std::chrono::seconds(60)) == Pop_Status::CLOSED;
+            }
+            if (closed)
+                woken.fetch_add(1);
+        });
+    }
+    std::this_thread::sleep_for(milliseconds(50));
+    start = steady_clock::now();
+    q.close();
+    for (thread& t : waiters)
+        t.join();
+    waited = duration<double, std::milli>(steady_clock::now() - start).count();
+    std::fprintf(stderr, "close: %u of %u waiters woken in %.3f ms\n", woken.load(), WAITERS, waited);
+    check("close wakes every waiter", woken.load() == WAITERS);
+
+    Blocking_Queue<int> r;
+    r.push(3);
+    r.push(4);
+    r.close();
+    int y[4];
+    check("closed queue drains first", r.pop(x) && x == 3 && r.pop_bulk(y, 4) == 1 && y[0] == 4);
+    check("then returns closed", !r.pop(x) && r.try_pop(x) == Pop_Status::CLOSED
+                                 && r.pop_for(x, milliseconds(1000)) == Pop_Status::CLOSED);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * blocking_shared_blocking_unique_pool.h
+ *
+ * A simple thread pool accepting callables as tasks and using:
+ *   - a pool task queue saving all submitted tasks
+ *   - several unique task queues within each worker thread
+ *   - a scheduler thread assigning tasks in pool queue to worker queues
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_SHARED_BLOCKING_UNIQUE_POOL_H
+#define BLOCKING_SHARED_BLOCKING_UNIQUE_POOL_H
+
+
+#include "blocking_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Blocking_Shared_Blocking_Unique_Pool = Thread_Pool<Worker_Queues<Blocking_Queue<Task_Wrapper>>,
+                                                         Placement,
+                                                         No_Steal,
+                                                         Block_Idle,
+                                                         Scheduled_Front>;
+
+
+#endif
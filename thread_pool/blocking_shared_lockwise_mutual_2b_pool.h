@@ -0,0 +1,37 @@
+/*
+ * blocking_shared_lockwise_mutual_2b_pool.h
+ *
+ * A simple thread pool accepting callables as tasks and using:
+ *   - a pool task queue saving all submitted tasks
+ *   - several mutual task queues within worker threads
+ *   - a scheduler thread assigning tasks in pool queue to worker queues
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * A worker pulls its own tasks at the back and steals at the front.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_SHARED_LOCKWISE_MUTUAL_2B_POOL_H
+#define BLOCKING_SHARED_LOCKWISE_MUTUAL_2B_POOL_H
+
+
+#include "lockwise_deque.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Blocking_Shared_Lockwise_Mutual_2b_Pool = Thread_Pool<Worker_Queues<Lockwise_Deque<Task_Wrapper>>,
+                                                            Placement,
+                                                            Steal<Back_End, Front_End>,
+                                                            Park_Idle,
+                                                            Scheduled_Front>;
+
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * blocking_shared_lockwise_mutual_pool.h
+ *
+ * A simple thread pool accepting callables as tasks and using:
+ *   - a pool task queue saving all submitted tasks
+ *   - several mutual task queues within worker threads
+ *   - a scheduler thread assigning tasks in pool queue to worker queues
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_SHARED_LOCKWISE_MUTUAL_POOL_H
+#define BLOCKING_SHARED_LOCKWISE_MUTUAL_POOL_H
+
+
+#include "lockwise_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Blocking_Shared_Lockwise_Mutual_Pool = Thread_Pool<Worker_Queues<Lockwise_Queue<Task_Wrapper>>,
+                                                         Placement,
+                                                         Steal<Front_End, Front_End>,
+                                                         Park_Idle,
+                                                         Scheduled_Front>;
+
+
+#endif
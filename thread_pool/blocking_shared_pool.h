@@ -0,0 +1,26 @@
+/*
+ * blocking_shared_pool.h
+ *
+ * A simple thread pool using a shared task queue among worker threads,
+ * accepting callables as tasks.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_SHARED_POOL_H
+#define BLOCKING_SHARED_POOL_H
+
+
+#include "blocking_queue.h"
+#include "thread_pool.h"
+
+
+typedef Thread_Pool<Shared_Queue<Blocking_Queue<Task_Wrapper>>,
+                    Random_Placement,
+                    No_Steal,
+                    Block_Idle,
+                    Direct_Front> Blocking_Shared_Pool;
+
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * blocking_test.cpp
+ *
+ * Testing Thread_Pool, then comparing Blocking_Queue and Futex_Queue by the
+ * latency of waking a parked consumer and by throughput under contention.
+ *
+ */
+
+#include <cstdio>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "blocking_queue.h"
+#include "blocking_unique_pool.h"
+#include "futex_queue.h"
+#include "latency.h"
+#include "producers_harness.h"
+
+
+using std::vector;
+
+
+// a stamp at a time, each after the consumer has had time to park
+template<class Queue>
+void wake_latency(char const* name) {
+    unsigned const ROUNDS = 2000;
+    Queue q;
+    Latency_Histogram latency;
+    thread consumer([&q, &latency] {
+        uint64_t stamp;
+        while (q.pop(stamp))
+            latency.record(latency_clock() - stamp);
+    });
+    for (unsigned i = 0; i < ROUNDS; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        q.push(latency_clock());
+    }
+    q.close();
+    consumer.join();
+    latency.report(stderr, name);
+}
+
+
+template<class Queue>
+void throughput(char const* name) {
+    unsigned const PRODUCERS = 4;
+    unsigned const CONSUMERS = 4;
+    uint64_t const ELEMENTS = 200000;
+    Queue q;
+    atomic<uint64_t> popped(0);
+    vector<thread> consumers;
+    vector<thread> producers;
+    time_point<steady_clock> start = steady_clock::now();
+    for (unsigned i = 0; i < CONSUMERS; ++i)
+        consumers.emplace_back([&q, &popped] {
+            uint64_t element;
+            uint64_t n = 0;
+            while (q.pop(element))
+                ++n;
+            popped.fetch_add(n);
+        });
+    for (unsigned i = 0; i < PRODUCERS; ++i)
+        producers.emplace_back([&q] {
+            for (uint64_t k = 0; k < ELEMENTS; ++k)
+                q.push(uint64_t(k));
+        });
+    for (thread& t : producers)
+        t.join();
+    q.close();
+    for (thread& t : consumers)
+        t.join();
+    double took = duration<double>(steady_clock::now() - start).count();
+    std::fprintf(stderr, "[%s] %u producers, %u consumers, %.0f elements/s\n",
+                 name, PRODUCERS, CONSUMERS, popped.load() / took);
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Blocking_Unique_Pool<>>("blocking_unique");
+
+    std::fprintf(stderr, "\nWaking a parked consumer:\n");
+    wake_latency<Blocking_Queue<uint64_t>>("blocking");
+    wake_latency<Futex_Queue<uint64_t>>("futex");
+    std::fprintf(stderr, "\nThroughput:\n");
+    throughput<Blocking_Queue<uint64_t>>("blocking");
+    throughput<Futex_Queue<uint64_t>>("futex");
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
+
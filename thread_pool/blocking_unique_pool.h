@@ -0,0 +1,27 @@
+/*
+ * blocking_unique_pool.h
+ *
+ * A simple thread pool using a unique task queue within each worker thread,
+ * accepting callables as tasks.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef BLOCKING_UNIQUE_POOL_H
+#define BLOCKING_UNIQUE_POOL_H
+
+
+#include "blocking_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Blocking_Unique_Pool = Thread_Pool<Worker_Queues<Blocking_Queue<Task_Wrapper>>,
+                                         Placement,
+                                         No_Steal,
+                                         Block_Idle,
+                                         Direct_Front>;
+
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * bulk_test.cpp
+ *
+ * Fanning out batches of tiny tasks to Thread_Pool one by one and in bulk,
+ * to workers which take one task or a batch of tasks from the shared queue
+ * at a time, and checking that a batch bigger than a bounded ring reaches
+ * parked workers.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "lockfree_shared_pool.h"
+#include "lockwise_shared_pool.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::thread;
+using std::vector;
+
+
+struct Tick {
+    atomic<size_t>* _count_;
+    void operator()() const {
+        _count_->fetch_add(1, memory_order_relaxed);
+    }
+};
+
+
+void run(char const* name, unsigned mode, unsigned batchsize = 1) {
+    size_t const BATCH = 10000;
+    unsigned const ROUNDS = 1000;
+    atomic<size_t> count(0);
+    vector<Tick> batch(BATCH, Tick{&count});
+
+    Pool_Config config;
+    config._batchsize_ = batchsize;
+    Lockwise_Shared_Pool pool(config);
+    time_point<steady_clock> start = steady_clock::now();
+    for (unsigned r = 0; r < ROUNDS; ++r) {
+        switch (mode) {
+        case 0:
+            for (size_t i = 0; i < BATCH; ++i)
+                pool.submit(batch[i]);
+            break;
+        case 1:
+            pool.submit_bulk(batch.begin(), batch.end());
+            break;
+        case 2:
+            for (size_t i = 0; i < BATCH; ++i)
+                pool.post(batch[i]);
+            break;
+        default:
+            pool.post_bulk(batch.begin(), batch.end());
+        }
+        while (count.load(memory_order_relaxed) < (r + 1) * BATCH)
+            std::this_thread::yield();
+    }
+    double took = duration<double>(steady_clock::now() - start).count();
+    std::fprintf(stderr, "\n[%s, batch size %u] %u batches of %zu tasks, took %.3f seconds, %.0f tasks per second.\n",
+                 name, batchsize, ROUNDS, BATCH, took, ROUNDS * BATCH / took);
+}
+
+
+// the workers parked, a batch more than the ring holds; post_bulk() used to
+// wait for room with none of the workers woken to make it
+bool check_parked() {
+    size_t const BATCH = 10000;
+    atomic<size_t> count(0);
+    vector<Tick> batch(BATCH, Tick{&count});
+
+    Pool_Config config;
+    config._workersize_ = 2;
+    Lockfree_Shared_Pool pool(config);
+    std::this_thread::sleep_for(milliseconds(300));
+    thread poster([&pool, &batch] { pool.post_bulk(batch.begin(), batch.end()); });
+    time_point<steady_clock> deadline = steady_clock::now() + seconds(10);
+    while (count.load(memory_order_relaxed) < BATCH && steady_clock::now() < deadline)
+        std::this_thread::yield();
+    bool ok = count.load() == BATCH;
+    std::fprintf(stderr, "\n[%s] %zu of %zu tasks bulk posted to parked workers run.\n",
+                 ok ? "ok" : "FAILED", count.load(), BATCH);
+    if (!ok)
+        std::_Exit(EXIT_FAILURE);       // the poster is stuck for good
+    poster.join();
+    return ok;
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n");
+
+    run("submit", 0);
+    run("submit_bulk", 1);
+    run("post", 2);
+    run("post_bulk", 3);
+    run("post_bulk", 3, 4);
+    run("post_bulk", 3, 16);
+    run("post_bulk", 3, 32);
+    bool ok = check_parked();
+
+    std::fprintf(stderr, "\nBye...\n");
+    return ok ? 0 : 1;
+}
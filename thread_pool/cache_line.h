@@ -0,0 +1,43 @@
+/*
+ * cache_line.h
+ *
+ * Keeping data written by different threads off each other's cache lines.
+ *   - CACHE_LINE_SIZE is std::hardware_destructive_interference_size where
+ *     the library has it, or else 64
+ *   - Padded<T> is a T aligned to and filling whole cache lines, so that
+ *     neither array neighbours nor members next to it share its lines
+ *
+ */
+
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+
+#include <cstddef>
+
+#include <new>
+
+
+#ifdef __cpp_lib_hardware_interference_size
+// GCC warns the value may change with -mtune, but nothing here crosses an
+// ABI boundary built with other flags
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+constexpr size_t CACHE_LINE_SIZE = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+constexpr size_t CACHE_LINE_SIZE = 64;
+#endif
+
+
+template<class T>
+struct alignas(CACHE_LINE_SIZE) Padded : T {
+    using T::T;
+};
+
+
+#endif
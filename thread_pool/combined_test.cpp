@@ -0,0 +1,21 @@
+/*
+ * combined_test.cpp
+ *
+ * Testing Thread_Pool.
+ *
+ */
+
+#include <cstdio>
+
+#include "blocking_shared_blocking_unique_pool.h"
+#include "producers_harness.h"
+
+
+int main() {
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Blocking_Shared_Blocking_Unique_Pool<>>("blocking_shared_blocking_unique");
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
+
@@ -0,0 +1,87 @@
+/*
+ * event_count.h
+ *
+ * An event count for parking threads which poll for a condition.
+ *   - waiting side: key = prepare_wait(), check the condition again, then
+ *     cancel_wait() if it holds or wait(key) if it does not
+ *   - notifying side: make the condition hold, then notify_one(), notify(n)
+ *     or notify_all(), which cost no more than a load when nobody waits
+ *   - sleeping relies on std::atomic::wait, i.e. a futex on Linux
+ *
+ * A notification between prepare_wait() and wait() changes the epoch, so
+ * wait() returns at once and no wakeup is lost.
+ *
+ */
+
+#ifndef EVENT_COUNT_H
+#define EVENT_COUNT_H
+
+
+#include <atomic>
+
+
+using std::atomic;
+using std::atomic_thread_fence;
+using std::memory_order_relaxed;
+using std::memory_order_seq_cst;
+
+
+class Event_Count {
+
+  private:
+    atomic<unsigned> _epoch_;
+    atomic<unsigned> _waiters_;
+
+  public:
+    Event_Count() : _epoch_(0), _waiters_(0) {}
+
+    unsigned prepare_wait() {
+        _waiters_.fetch_add(1, memory_order_seq_cst);
+        atomic_thread_fence(memory_order_seq_cst);
+        return _epoch_.load(memory_order_seq_cst);
+    }
+
+    void cancel_wait() {
+        _waiters_.fetch_sub(1, memory_order_relaxed);
+    }
+
+    void wait(unsigned key) {
+        _epoch_.wait(key, memory_order_seq_cst);
+        _waiters_.fetch_sub(1, memory_order_relaxed);
+    }
+
+    void notify_one() {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (_waiters_.load(memory_order_relaxed) == 0)
+            return;
+        _epoch_.fetch_add(1, memory_order_seq_cst);
+        _epoch_.notify_one();
+    }
+
+    // wakes up no more than n waiters
+    void notify(unsigned n) {
+        atomic_thread_fence(memory_order_seq_cst);
+        unsigned waiters = _waiters_.load(memory_order_relaxed);
+        if (waiters == 0 || n == 0)
+            return;
+        _epoch_.fetch_add(1, memory_order_seq_cst);
+        if (n >= waiters) {
+            _epoch_.notify_all();
+        } else {
+            while (n--)
+                _epoch_.notify_one();
+        }
+    }
+
+    void notify_all() {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (_waiters_.load(memory_order_relaxed) == 0)
+            return;
+        _epoch_.fetch_add(1, memory_order_seq_cst);
+        _epoch_.notify_all();
+    }
+
+};
+
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * false_sharing_test.cpp
+ *
+ * Every thread pushing to and popping from a Lockwise_Queue of its own, as
+ * the workers of lockwise_unique_pool.h do, with the queues packed in one
+ * array and with each of them padded to whole cache lines.
+ *
+ */
+
+#include <cstdio>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "cache_line.h"
+#include "lockwise_queue.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::thread;
+using std::vector;
+
+
+template<class Queue>
+void run(char const* name) {
+    duration<double> PERIOD(1);
+    unsigned threadsize = thread::hardware_concurrency();
+    if (threadsize < 2)
+        threadsize = 2;
+    Queue* queues = new Queue[threadsize]();
+    vector<size_t> counter(threadsize, 0);
+    vector<thread> threads;
+    time_point<steady_clock> start;
+    atomic<bool> go(false);
+
+    for (unsigned i = 0; i < threadsize; ++i) {
+        threads.emplace_back([PERIOD, i, queues, &counter, &start, &go] {
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            size_t n = 0;
+            size_t element;
+            for (; steady_clock::now() - start <= PERIOD; ++n) {
+                queues[i].push(std::move(n));
+                queues[i].pop(element);
+            }
+            counter[i] = n;
+        });
+    }
+    start = steady_clock::now();
+    go.store(true, memory_order_release);
+    for (thread& t : threads)
+        t.join();
+    delete[] queues;
+
+    size_t total = 0;
+    for (size_t n : counter)
+        total += n;
+    std::fprintf(stderr, "\n[%s] %zu bytes a queue, %u threads, %.0f push/pop pairs per second.\n",
+                 name, sizeof(Queue), threadsize, total / PERIOD.count());
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n");
+
+    run<Lockwise_Queue<size_t>>("packed");
+    run<Padded<Lockwise_Queue<size_t>>>("padded");
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
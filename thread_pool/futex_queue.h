@@ -0,0 +1,180 @@
+/*
+ * futex_queue.h
+ *
+ * A generic queue supporting concurrency access.
+ *   - blocking, as Blocking_Queue, and a drop-in for it
+ *   - elements in a Lockwise_Queue, consumers counting them off a single
+ *     atomic counter and parking on it by std::atomic::wait, i.e. a futex
+ *     on Linux, instead of a mutex and condition_variable
+ *   - element type is movable
+ *
+ * A producer pushes its element and then adds it to the count; a consumer
+ * takes from the count first and then pops as many, which are there for
+ * sure.  A consumer finding the count at 0 spins for a while and then
+ * parks, and a producer notifies only if somebody is parked, so neither
+ * side makes a syscall when the other keeps up.  close() sets the top bit
+ * of the counter, which wakes every parked consumer; the elements left are
+ * still popped, and after them pop() returns false and pop_bulk() 0.
+ *
+ * std::atomic::wait has no timeout, so there is no pop_for() here.
+ *
+ */
+
+#ifndef FUTEX_QUEUE_H
+#define FUTEX_QUEUE_H
+
+
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+
+#include "blocking_queue.h"
+#include "cache_line.h"
+#include "lockwise_queue.h"
+#include "spinlock_mutex.h"
+
+
+using std::atomic;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_seq_cst;
+
+
+template<class T, class Mutex = TTAS_Mutex>
+class Futex_Queue {
+
+  private:
+    static constexpr uint32_t CLOSED = uint32_t(1) << 31;
+    static constexpr uint32_t COUNT_MASK = CLOSED - 1;
+    static constexpr unsigned SPIN_LIMIT = 128;
+
+    Lockwise_Queue<T, Mutex> _q_;
+    // what consumers poll apart from what producers lock
+    alignas(CACHE_LINE_SIZE) atomic<uint32_t> _count_;
+    atomic<uint32_t> _waiters_;
+
+    // takes no more than max off the count, 0 if it is at 0
+    uint32_t claim(uint32_t max) {
+        uint32_t c = _count_.load(memory_order_acquire);
+        while (c & COUNT_MASK) {
+            uint32_t k = std::min(c & COUNT_MASK, max);
+            if (_count_.compare_exchange_weak(c, c - k, memory_order_acquire, memory_order_relaxed))
+                return k;
+        }
+        return 0;
+    }
+
+    // 0 once closed and drained
+    uint32_t claim_or_wait(uint32_t max) {
+        for (unsigned i = 0; ; ++i) {
+            if (uint32_t k = claim(max))
+                return k;
+            uint32_t c = _count_.load(memory_order_seq_cst);
+            if (c & COUNT_MASK)
+                continue;
+            if (c & CLOSED)
+                return 0;
+            if (i < SPIN_LIMIT) {
+                cpu_relax();
+                continue;
+            }
+            // pairs with the count then waiters of a producer, so either it
+            // sees this waiter or this wait sees its count
+            _waiters_.fetch_add(1, memory_order_seq_cst);
+            _count_.wait(c, memory_order_seq_cst);
+            _waiters_.fetch_sub(1, memory_order_relaxed);
+        }
+    }
+
+    // the k claimed, in the queue already
+    void take(T* elements, uint32_t k) {
+        for (size_t n = 0; n < k; )
+            n += _q_.pop_bulk(elements + n, k - n);
+    }
+
+    void wake(uint32_t n) {
+        uint32_t waiters = _waiters_.load(memory_order_seq_cst);
+        if (n >= waiters) {
+            if (waiters > 1)
+                _count_.notify_all();
+            else if (waiters == 1)
+                _count_.notify_one();
+        } else {
+            for (uint32_t i = 0; i < n; ++i)
+                _count_.notify_one();
+        }
+    }
+
+  public:
+    Futex_Queue() : _count_(0), _waiters_(0) {}
+
+    void push(T&& element) {
+        _q_.push(std::move(element));
+        _count_.fetch_add(1, memory_order_seq_cst);
+        wake(1);
+    }
+
+    void push_bulk(T* elements, size_t n) {
+        if (!n)
+            return;
+        _q_.push_bulk(elements, n);
+        _count_.fetch_add(n, memory_order_seq_cst);
+        wake(n);
+    }
+
+    // false once closed and drained
+    bool pop(T& element) {
+        if (!claim_or_wait(1))
+            return false;
+        take(&element, 1);
+        return true;
+    }
+
+    // waits for one element at least, then moves out no more than max
+    // elements, returns how many, 0 once closed and drained
+    size_t pop_bulk(T* elements, size_t max) {
+        uint32_t k = claim_or_wait(std::min<size_t>(max, COUNT_MASK));
+        take(elements, k);
+        return k;
+    }
+
+    Pop_Status try_pop(T& element) {
+        if (claim(1)) {
+            take(&element, 1);
+            return Pop_Status::POPPED;
+        }
+        return _count_.load(memory_order_acquire) == CLOSED ? Pop_Status::CLOSED : Pop_Status::EMPTY;
+    }
+
+    // no more than max elements, without waiting, returns how many
+    size_t try_pop_bulk(T* elements, size_t max) {
+        uint32_t k = claim(std::min<size_t>(max, COUNT_MASK));
+        take(elements, k);
+        return k;
+    }
+
+    // wakes every waiter, once
+    void close() {
+        _count_.fetch_or(CLOSED, memory_order_seq_cst);
+        if (_waiters_.load(memory_order_seq_cst))
+            _count_.notify_all();
+    }
+
+    bool closed() const {
+        return _count_.load(memory_order_acquire) & CLOSED;
+    }
+
+    // elements not taken yet
+    bool empty() const {
+        return !size();
+    }
+
+    size_t size() const {
+        return _count_.load(memory_order_acquire) & COUNT_MASK;
+    }
+
+};
+
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * futex_unique_pool.h
+ *
+ * A simple thread pool using a unique task queue within each worker thread,
+ * accepting callables as tasks.
+
+Idle workers park on the futex of their queue, see futex_queue.h.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef FUTEX_UNIQUE_POOL_H
+#define FUTEX_UNIQUE_POOL_H
+
+
+#include "futex_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Futex_Unique_Pool = Thread_Pool<Worker_Queues<Futex_Queue<Task_Wrapper>>,
+                                      Placement,
+                                      No_Steal,
+                                      Block_Idle,
+                                      Direct_Front>;
+
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * idle.h
+ *
+ * Idle policies of Thread_Pool, telling what a worker does when it finds no
+ * task.
+ *   - Park_Idle: yield for a while (the spin budget), then park on an event
+ *     count until a task is submitted
+ *   - Block_Idle: block in a Blocking_Queue or Futex_Queue, which wakes the
+ *     worker itself
+ *   - Adaptive_Idle: spin, then yield, then park, spinning and yielding
+ *     for as long as twice the mean of its recent idle periods, so it
+ *     spins when tasks come often and parks at once when they come
+ *     seldom; a mean above Pool_Config::_spinlimit_ means no spinning,
+ *     and on a single CPU it yields instead, as a spinning worker would
+ *     only keep the submitters off
+ *
+ * Park_Idle and Adaptive_Idle poll the queues, so a pool of blocking
+ * queues which takes either of them does not block in the queues but
+ * parks like the others, see With_Idle in thread_pool.h.
+ *
+ * Workers park in groups, every group on an event count of its own, and
+ * submitting into a queue wakes its group.  A pool has one group if its
+ * workers steal from each other and one per queue otherwise.  Park_Groups
+ * keeps the groups for Park_Idle and Adaptive_Idle.
+ *
+ */
+
+#ifndef IDLE_H
+#define IDLE_H
+
+
+#include <cstdint>
+
+#include <algorithm>
+#include <thread>
+
+#include "cache_line.h"
+#include "event_count.h"
+#include "latency.h"
+#include "pool_config.h"
+#include "spinlock_mutex.h"
+
+
+class Park_Groups {
+
+  private:
+    unsigned _groupsize_;
+    Padded<Event_Count>* _groups_;
+
+  protected:
+    explicit Park_Groups(unsigned groupsize)
+        : _groupsize_(groupsize), _groups_(new Padded<Event_Count>[groupsize]()) {}
+    ~Park_Groups() {
+        delete[] _groups_;
+    }
+
+    Event_Count& group(unsigned index) {
+        return _groups_[index];
+    }
+
+    // starving() checks again whether there is nothing to do
+    template<class Starving>
+    static void park(Event_Count& group, Starving starving) {
+        unsigned key = group.prepare_wait();
+        if (starving())
+            group.wait(key);
+        else
+            group.cancel_wait();
+    }
+
+  public:
+    Park_Groups(Park_Groups const&) = delete;
+    Park_Groups& operator=(Park_Groups const&) = delete;
+
+    // wakes no more than n workers of the group
+    void notify(unsigned group, unsigned n) {
+        if (n == 1)
+            _groups_[group].notify_one();
+        else
+            _groups_[group].notify(n);
+    }
+
+    void notify_all() {
+        for (unsigned i = 0; i < _groupsize_; ++i)
+            _groups_[i].notify_all();
+    }
+
+};
+
+
+class Park_Idle : public Park_Groups {
+
+  private:
+    unsigned _spinbudget_;
+
+  public:
+    static constexpr bool BLOCKS = false;
+
+    Park_Idle(unsigned groupsize, Pool_Config const& config)
+        : Park_Groups(groupsize), _spinbudget_(config._spinbudget_) {}
+
+    // the idle state of one worker
+    class Waiter {
+
+      private:
+        Park_Idle& _idle_;
+        Event_Count& _group_;
+        unsigned _spins_;
+
+      public:
+        Waiter(Park_Idle& idle, unsigned group)
+            : _idle_(idle), _group_(idle.group(group)), _spins_(0) {}
+
+        void busy() {
+            _spins_ = 0;
+        }
+
+        // starving() checks again whether there is nothing to do
+        template<class Starving>
+        void idle(Starving starving) {
+            if (_spins_ < _idle_._spinbudget_) {
+                ++_spins_;
+                std::this_thread::yield();
+                return;
+            }
+            park(_group_, starving);
+            _spins_ = 0;
+        }
+
+    };
+
+};
+
+
+class Adaptive_Idle : public Park_Groups {
+
+  private:
+    uint64_t _spinlimit_;
+    bool _spins_;
+
+  public:
+    static constexpr bool BLOCKS = false;
+
+    Adaptive_Idle(unsigned groupsize, Pool_Config const& config)
+        : Park_Groups(groupsize), _spinlimit_(config._spinlimit_),
+          _spins_(std::thread::hardware_concurrency() > 1) {}
+
+    // the idle state of one worker, with what it learned of the last ones
+    class Waiter {
+
+      private:
+        Adaptive_Idle& _idle_;
+        Event_Count& _group_;
+        uint64_t _mean_;        // of idle periods in nanoseconds, moving
+        uint64_t _since_;       // start of the idle period, 0 when busy
+
+        uint64_t budget() const {
+            return _mean_ > _idle_._spinlimit_ ? 0 : std::min(2 * _mean_, _idle_._spinlimit_);
+        }
+
+      public:
+        Waiter(Adaptive_Idle& idle, unsigned group)
+            : _idle_(idle), _group_(idle.group(group)), _mean_(idle._spinlimit_ / 4), _since_(0) {}
+
+        void busy() {
+            if (!_since_)
+                return;
+            uint64_t period = latency_clock() - _since_;
+            _mean_ = _mean_ - _mean_ / 8 + period / 8;
+            _since_ = 0;
+        }
+
+        // starving() checks again whether there is nothing to do
+        template<class Starving>
+        void idle(Starving starving) {
+            uint64_t now = latency_clock();
+            if (!_since_)
+                _since_ = now;
+            uint64_t budget = this->budget();
+            if (now - _since_ < budget && _idle_._spins_) {
+                cpu_relax();
+                return;
+            }
+            if (now - _since_ < 2 * budget) {
+                std::this_thread::yield();
+                return;
+            }
+            park(_group_, starving);
+        }
+
+    };
+
+};
+
+
+class Block_Idle {
+
+  public:
+    static constexpr bool BLOCKS = true;
+
+    Block_Idle(unsigned, Pool_Config const&) {}
+
+    void notify(unsigned, unsigned) {}
+    void notify_all() {}
+
+};
+
+
+#endif
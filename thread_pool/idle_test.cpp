@@ -0,0 +1,61 @@
+/*
+ * idle_test.cpp
+ *
+ * Measuring the CPU time Thread_Pool burns while it has nothing to do, with
+ * several spin budgets.
+ *
+ */
+
+#include <cstdio>
+#include <ctime>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "archery.h"
+#include "lockwise_mutual_pool.h"
+
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::thread;
+
+
+void run(char const* name, unsigned spinbudget) {
+    duration<double> PERIOD(5);
+
+    Pool_Config config;
+    config._spinbudget_ = spinbudget;
+    Lockwise_Mutual_Pool<> pool(config);
+
+    // a burst of tasks first, then nothing at all
+    for (unsigned i = 0; i < 1000; ++i)
+        pool.submit(shootAnarrow);
+    std::this_thread::sleep_for(duration<double>(0.5));
+
+    std::clock_t cpu = std::clock();
+    time_point<steady_clock> start = steady_clock::now();
+    std::this_thread::sleep_for(PERIOD);
+    double used = static_cast<double>(std::clock() - cpu) / CLOCKS_PER_SEC;
+    double idle = duration<double>(steady_clock::now() - start).count();
+    std::fprintf(stderr, "\n[%s] %.3f CPU seconds used in %.3f idle seconds by %u workers.\n",
+                 name, used, idle, thread::hardware_concurrency());
+
+    // parked workers must still wake up for a new task
+    Future<bool> r = pool.submit(std::bind(shootNarrows, 1));
+    r.get();
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n");
+
+    run("never park", ~0u);
+    run("spin budget 64", 64);
+    run("park at once", 0);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
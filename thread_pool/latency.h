@@ -0,0 +1,132 @@
+/*
+ * latency.h
+ *
+ * Task latencies of Thread_Pool.
+ *   - Latency_Histogram counts nanoseconds in log-scaled buckets, HDR style:
+ *     32 buckets to every power of two, so a percentile is off by no more
+ *     than about 3%, in a fixed array and with no atomics, as every worker
+ *     records into its own
+ *   - Task_Latency keeps three of them, for enqueue to dequeue (queueing),
+ *     dequeue to completion (execution) and submission to the future being
+ *     ready (end to end)
+ *
+ * Set Pool_Config::_latency_ to have a pool record them, it merges those of
+ * its workers there when it is destructed.
+ *
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+
+inline uint64_t latency_clock() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+class Latency_Histogram {
+
+  private:
+    static constexpr unsigned SUB_BITS = 6;
+    static constexpr uint64_t SUB = uint64_t(1) << SUB_BITS;
+    static constexpr uint64_t HALF = SUB / 2;
+    static constexpr unsigned BUCKET_SIZE = (64 - SUB_BITS + 1) * HALF + HALF;
+
+    uint64_t _buckets_[BUCKET_SIZE] = {};
+    uint64_t _count_ = 0;
+    uint64_t _max_ = 0;
+
+    // values below SUB have a bucket each, above that the top SUB_BITS bits
+    // of a value pick its bucket
+    static unsigned index(uint64_t v) {
+        if (v < SUB)
+            return v;
+        unsigned shift = std::bit_width(v) - SUB_BITS;
+        return shift * HALF + (v >> shift);
+    }
+
+    // the highest value of a bucket
+    static uint64_t highest(unsigned i) {
+        if (i < SUB)
+            return i;
+        unsigned shift = i / HALF - 1;
+        return (((i - shift * HALF) + uint64_t(1)) << shift) - 1;
+    }
+
+  public:
+    void record(uint64_t ns) {
+        ++_buckets_[index(ns)];
+        ++_count_;
+        _max_ = std::max(_max_, ns);
+    }
+
+    void merge(Latency_Histogram const& other) {
+        for (unsigned i = 0; i < BUCKET_SIZE; ++i)
+            _buckets_[i] += other._buckets_[i];
+        _count_ += other._count_;
+        _max_ = std::max(_max_, other._max_);
+    }
+
+    uint64_t count() const {
+        return _count_;
+    }
+
+    uint64_t max() const {
+        return _max_;
+    }
+
+    // q in [0, 1], e.g. 0.999 for p99.9
+    uint64_t percentile(double q) const {
+        if (!_count_)
+            return 0;
+        uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(q * _count_ + 0.5), 1);
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < BUCKET_SIZE; ++i) {
+            seen += _buckets_[i];
+            if (seen >= rank)
+                return std::min(highest(i), _max_);
+        }
+        return _max_;
+    }
+
+    void report(FILE* out, char const* name) const {
+        std::fprintf(out, "[%s] %llu tasks, p50 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns\n",
+                     name, static_cast<unsigned long long>(_count_),
+                     static_cast<unsigned long long>(percentile(0.5)),
+                     static_cast<unsigned long long>(percentile(0.99)),
+                     static_cast<unsigned long long>(percentile(0.999)),
+                     static_cast<unsigned long long>(_max_));
+    }
+
+};
+
+
+struct Task_Latency {
+    Latency_Histogram _queueing_;
+    Latency_Histogram _execution_;
+    Latency_Histogram _endtoend_;
+
+    void merge(Task_Latency const& other) {
+        _queueing_.merge(other._queueing_);
+        _execution_.merge(other._execution_);
+        _endtoend_.merge(other._endtoend_);
+    }
+
+    void report(FILE* out) const {
+        _queueing_.report(out, "queueing");
+        _execution_.report(out, "execution");
+        _endtoend_.report(out, "end to end");
+    }
+};
+
+
+#endif
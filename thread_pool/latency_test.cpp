@@ -0,0 +1,49 @@
+/*
+ * latency_test.cpp
+ *
+ * Measuring the queueing, execution and end-to-end latencies of tasks in
+ * Thread_Pool, at a steady rate and then in a burst.
+ *
+ */
+
+#include <cstdio>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "archery.h"
+#include "latency.h"
+#include "lockwise_mutual_pool.h"
+
+
+using std::chrono::microseconds;
+
+
+void run(char const* name, unsigned bursts, unsigned burstsize) {
+    Task_Latency latency;
+    {
+        Pool_Config config;
+        config._latency_ = &latency;
+        Lockwise_Mutual_Pool<> pool(config);
+
+        for (unsigned i = 0; i < bursts; ++i) {
+            for (unsigned j = 0; j < burstsize; ++j)
+                pool.submit(std::bind(shootNarrows, j));
+            std::this_thread::sleep_for(microseconds(100));
+        }
+    }
+    std::fprintf(stderr, "\n%s:\n", name);
+    latency.report(stderr);
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n");
+
+    run("one task every 100 microseconds", 10000, 1);
+    run("bursts of 1000 tasks", 10, 1000);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
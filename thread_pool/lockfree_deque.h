@@ -0,0 +1,199 @@
+/*
+ * lockfree_deque.h
+ *
+ * A generic deque supporting concurrency access.
+ *   - nonblocking
+ *   - lock-free Chase-Lev work-stealing deque over a growable circular array
+ *   - push() and pull() at the bottom by the owner thread only
+ *   - pop() at the top by any thread
+ *   - element type is movable and trivially relocatable
+ *
+ * A thief has to copy a slot before its CAS on _top_ tells whether the slot
+ * is really its own, so elements are kept as the raw words of their object
+ * representation and moved in and out bitwise.  A Task_Wrapper satisfies
+ * that after make_relocatable(), which its caller has to see to.
+ *
+ */
+
+#ifndef LOCKFREE_DEQUE_H
+#define LOCKFREE_DEQUE_H
+
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "cache_line.h"
+
+
+using std::atomic;
+using std::atomic_thread_fence;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::memory_order_seq_cst;
+
+
+template<class T>
+class Lockfree_Deque {
+
+  private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uintptr_t) - 1) / sizeof(uintptr_t);
+
+    struct Raw {
+        uintptr_t _w_[WORDS];
+    };
+
+    struct Array {
+        size_t _mask_;
+        Array* _prev_;      // retired arrays stay alive for late thieves
+        atomic<uintptr_t>* _words_;
+
+        Array(size_t capacity, Array* prev)
+            : _mask_(capacity - 1), _prev_(prev),
+              _words_(new atomic<uintptr_t>[capacity * WORDS]) {}
+        ~Array() {
+            delete[] _words_;
+        }
+
+        size_t capacity() const {
+            return _mask_ + 1;
+        }
+        void put(long i, Raw const& r) {
+            atomic<uintptr_t>* w = _words_ + (i & _mask_) * WORDS;
+            for (size_t k = 0; k < WORDS; ++k)
+                w[k].store(r._w_[k], memory_order_relaxed);
+        }
+        void get(long i, Raw& r) const {
+            atomic<uintptr_t> const* w = _words_ + (i & _mask_) * WORDS;
+            for (size_t k = 0; k < WORDS; ++k)
+                r._w_[k] = w[k].load(memory_order_relaxed);
+        }
+    };
+
+    // thieves write the top, the owner writes the bottom
+    alignas(CACHE_LINE_SIZE) atomic<long> _top_;
+    alignas(CACHE_LINE_SIZE) atomic<long> _bottom_;
+    atomic<Array*> _array_;
+
+    static void pack(T&& element, Raw& r) {
+        alignas(T) unsigned char buf[sizeof(Raw)];
+        new (buf) T(std::move(element));
+        std::memset(&r, 0, sizeof(Raw));
+        std::memcpy(&r, buf, sizeof(T));
+    }
+
+    static void unpack(Raw const& r, T& element) {
+        alignas(T) unsigned char buf[sizeof(Raw)];
+        std::memcpy(buf, &r, sizeof(T));
+        T* p = std::launder(reinterpret_cast<T*>(buf));
+        element = std::move(*p);
+        p->~T();
+    }
+
+    Array* grow(Array* a, long b, long t) {
+        Array* bigger = new Array(a->capacity() * 2, a);
+        Raw r;
+        for (long i = t; i < b; ++i) {
+            a->get(i, r);
+            bigger->put(i, r);
+        }
+        _array_.store(bigger, memory_order_release);
+        return bigger;
+    }
+
+  public:
+    explicit Lockfree_Deque(size_t capacity = 256) : _top_(0), _bottom_(0) {
+        size_t n = 2;
+        while (n < capacity)
+            n <<= 1;
+        _array_.store(new Array(n, nullptr), memory_order_relaxed);
+    }
+
+    ~Lockfree_Deque() {
+        T element;
+        while (pull(element)) {}
+        Array* a = _array_.load(memory_order_relaxed);
+        while (a) {
+            Array* prev = a->_prev_;
+            delete a;
+            a = prev;
+        }
+    }
+
+    Lockfree_Deque(Lockfree_Deque const&) = delete;
+    Lockfree_Deque& operator=(Lockfree_Deque const&) = delete;
+
+    // owner only
+    void push(T&& element) {
+        long b = _bottom_.load(memory_order_relaxed);
+        long t = _top_.load(memory_order_acquire);
+        Array* a = _array_.load(memory_order_relaxed);
+        if (b - t > static_cast<long>(a->capacity()) - 1)
+            a = grow(a, b, t);
+        Raw r;
+        pack(std::move(element), r);
+        a->put(b, r);
+        atomic_thread_fence(memory_order_release);
+        _bottom_.store(b + 1, memory_order_relaxed);
+    }
+
+    // any thread
+    bool pop(T& element) {
+        long t = _top_.load(memory_order_acquire);
+        for (;;) {
+            atomic_thread_fence(memory_order_seq_cst);
+            long b = _bottom_.load(memory_order_acquire);
+            if (t >= b)
+                return false;
+            Array* a = _array_.load(memory_order_acquire);
+            Raw r;
+            a->get(t, r);
+            if (_top_.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+                unpack(r, element);
+                return true;
+            }
+        }
+    }
+
+    // owner only
+    bool pull(T& element) {
+        long b = _bottom_.load(memory_order_relaxed) - 1;
+        Array* a = _array_.load(memory_order_relaxed);
+        _bottom_.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        long t = _top_.load(memory_order_relaxed);
+        if (t > b) {
+            _bottom_.store(b + 1, memory_order_relaxed);
+            return false;
+        }
+        Raw r;
+        a->get(b, r);
+        if (t == b) {
+            // the last element, race the thieves for it
+            bool won = _top_.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+            _bottom_.store(b + 1, memory_order_relaxed);
+            if (!won)
+                return false;
+        }
+        unpack(r, element);
+        return true;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t size() const {
+        long b = _bottom_.load(memory_order_acquire);
+        long t = _top_.load(memory_order_acquire);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+};
+
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * lockfree_deque_test.cpp
+ *
+ * Testing Lockfree_Deque, the Chase-Lev deque: an owner pushing and pulling
+ * at the bottom against thieves popping at the top, and every element comes
+ * out once, whoever takes it.
+ *   - bursts of pushes into a deque of 2 slots at first, so that it grows
+ *     while thieves may still read the arrays it retires
+ *   - a push then a pull, one element at a time, so that the owner and the
+ *     thieves race for the last element
+ *
+ */
+
+#include <cstdio>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "lockfree_deque.h"
+
+
+using std::atomic;
+using std::thread;
+using std::vector;
+
+
+void check(char const* what, bool ok) {
+    std::fprintf(stderr, "[%s] %s\n", ok ? "ok" : "FAILED", what);
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    Lockfree_Deque<unsigned> d(2);
+    unsigned x = 0;
+    check("pull and pop of an empty deque", !d.pull(x) && !d.pop(x) && d.empty());
+    for (unsigned i = 0; i < 100; ++i)
+        d.push(unsigned(i));
+    bool ends = d.size() == 100;
+    ends = d.pull(x) && x == 99 && ends;
+    ends = d.pop(x) && x == 0 && ends;
+    check("grown to 100, pull from the bottom, pop from the top", ends);
+    while (d.pull(x)) {}
+    check("drained", d.empty());
+
+    unsigned const THIEVES = 3;
+    unsigned const BURSTS = 2000;
+    unsigned const SINGLES = 200000;
+    unsigned total = 0;
+    for (unsigned b = 0; b < BURSTS; ++b)
+        total += b % 300 + 1;
+    total += SINGLES;
+
+    Lockfree_Deque<unsigned> q(2);
+    atomic<bool> done(false);
+    vector<vector<unsigned>> seen(THIEVES + 1);
+    vector<thread> thieves;
+    for (unsigned t = 1; t <= THIEVES; ++t) {
+        thieves.emplace_back([t, &q, &done, &seen] {
+            unsigned element;
+            for (;;) {
+                if (q.pop(element))
+                    seen[t].push_back(element);
+                else if (done.load(memory_order_acquire))
+                    break;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // the owner, leaving some of every burst to the thieves
+    unsigned next = 0;
+    unsigned element;
+    for (unsigned b = 0; b < BURSTS; ++b) {
+        unsigned n = b % 300 + 1;
+        for (unsigned i = 0; i < n; ++i)
+            q.push(unsigned(next++));
+        for (unsigned i = 0; i < n / 2 && q.pull(element); ++i)
+            seen[0].push_back(element);
+    }
+    while (q.pull(element))
+        seen[0].push_back(element);
+    for (unsigned i = 0; i < SINGLES; ++i) {
+        q.push(unsigned(next++));
+        if (q.pull(element))
+            seen[0].push_back(element);
+    }
+    done.store(true, memory_order_release);
+    for (thread& t : thieves)
+        t.join();
+    while (q.pull(element))
+        seen[0].push_back(element);
+
+    vector<unsigned> counts(total, 0);
+    size_t stolen = 0;
+    for (unsigned t = 0; t <= THIEVES; ++t) {
+        for (unsigned e : seen[t])
+            if (e < total)
+                ++counts[e];
+        if (t)
+            stolen += seen[t].size();
+    }
+    size_t lost = 0;
+    size_t duplicated = 0;
+    for (unsigned n : counts) {
+        if (n == 0)
+            ++lost;
+        else if (n > 1)
+            duplicated += n - 1;
+    }
+    std::fprintf(stderr, "owner and %u thieves: %zu stolen, %zu lost, %zu duplicated of %u\n",
+                 THIEVES, stolen, lost, duplicated, total);
+    check("no element lost or duplicated", next == total && !lost && !duplicated && q.empty());
+
+    std::fprintf(stderr, "\nBye...\n");
+    return lost || duplicated ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * lockfree_mutual_pool.h
+ *
+ * A simple thread pool using a mutual task queue within each worker thread,
+ * accepting callables as tasks.
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * The mutual task queue is a lock-free work-stealing deque which only its
+ * owner may push into, so submitted tasks go through a lockwise inbox of the
+ * worker first.  The owner moves them from its inbox into its deque, pulls
+ * its own tasks at the bottom, and the others pop (steal) them at the top.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKFREE_MUTUAL_POOL_H
+#define LOCKFREE_MUTUAL_POOL_H
+
+
+#include "lockfree_deque.h"
+#include "lockwise_queue.h"
+#include "thread_pool.h"
+
+
+// a lock-free work-stealing deque owned by a worker, with a lockwise inbox
+// for the tasks others submit; T is Task_Wrapper, made relocatable on its
+// way into the deque
+template<class T>
+class Lockfree_Inbox_Deque {
+
+  private:
+    static constexpr unsigned TRANSFER_LIMIT = 32;
+
+    Lockfree_Deque<T> _deque_;
+    Lockwise_Queue<T> _inbox_;
+
+  public:
+    void push(T&& element) {
+        _inbox_.push(std::move(element));
+    }
+
+    void push_bulk(T* elements, size_t n) {
+        _inbox_.push_bulk(elements, n);
+    }
+
+    // owner only, straight into the deque, where the owner pulls it next
+    void push_local(T&& element) {
+        element.make_relocatable();
+        _deque_.push(std::move(element));
+    }
+
+    // owner only, moves a batch from the inbox into the deque when empty
+    bool pull(T& element) {
+        if (_deque_.pull(element))
+            return true;
+        T batch[TRANSFER_LIMIT];
+        size_t n = _inbox_.pop_bulk(batch, TRANSFER_LIMIT);
+        if (n == 0)
+            return false;
+        element = std::move(batch[0]);
+        for (size_t i = 1; i < n; ++i) {
+            batch[i].make_relocatable();
+            _deque_.push(std::move(batch[i]));
+        }
+        return true;
+    }
+
+    // any thread
+    bool pop(T& element) {
+        return _deque_.pop(element) || _inbox_.pop(element);
+    }
+
+    // any thread; the lock-free deque gives one at a time, so half of the
+    // inbox only when the deque is empty
+    size_t pop_half(T* elements, size_t max) {
+        if (max > 0 && _deque_.pop(elements[0]))
+            return 1;
+        return _inbox_.pop_half(elements, max);
+    }
+
+    bool empty() const {
+        return _deque_.empty() && _inbox_.empty();
+    }
+
+    size_t size() const {
+        return _deque_.size() + _inbox_.size();
+    }
+
+};
+
+
+template<class Placement = Random_Placement>
+using Lockfree_Mutual_Pool = Thread_Pool<Worker_Queues<Lockfree_Inbox_Deque<Task_Wrapper>>,
+                                         Placement,
+                                         Steal<Back_End, Front_End>,
+                                         Park_Idle,
+                                         Direct_Front>;
+
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * lockfree_queue.h
+ *
+ * A generic queue supporting concurrency access.
+ *   - nonblocking
+ *   - lock-free bounded ring buffer with a sequence number per slot
+ *     (Dmitry Vyukov's MPMC queue), capacity is a power of two
+ *   - push() waits while the queue is full, try_push() does not
+ *   - try_push_bulk() pushes no more than there is room for, so that its
+ *     caller can wake consumers before it pushes the rest
+ *   - element type is movable
+ *
+ */
+
+#ifndef LOCKFREE_QUEUE_H
+#define LOCKFREE_QUEUE_H
+
+
+#include <cstdint>
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <utility>
+
+#include "cache_line.h"
+
+
+using std::atomic;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+
+
+template<class T>
+class Lockfree_Queue {
+
+  private:
+    struct Cell {
+        atomic<size_t> _seq_;
+        alignas(T) unsigned char _data_[sizeof(T)];
+
+        T* element() {
+            return std::launder(reinterpret_cast<T*>(_data_));
+        }
+    };
+
+    size_t _mask_;
+    Cell* _cells_;
+    // producers and consumers each on a line of their own
+    alignas(CACHE_LINE_SIZE) atomic<size_t> _enqueue_;
+    alignas(CACHE_LINE_SIZE) atomic<size_t> _dequeue_;
+
+  public:
+    explicit Lockfree_Queue(size_t capacity = 4096) : _enqueue_(0), _dequeue_(0) {
+        size_t n = 2;
+        while (n < capacity)
+            n <<= 1;
+        _mask_ = n - 1;
+        _cells_ = new Cell[n];
+        for (size_t i = 0; i < n; ++i)
+            _cells_[i]._seq_.store(i, memory_order_relaxed);
+    }
+
+    ~Lockfree_Queue() {
+        T element;
+        while (pop(element)) {}
+        delete[] _cells_;
+    }
+
+    Lockfree_Queue(Lockfree_Queue const&) = delete;
+    Lockfree_Queue& operator=(Lockfree_Queue const&) = delete;
+
+    bool try_push(T&& element) {
+        Cell* cell;
+        size_t pos = _enqueue_.load(memory_order_relaxed);
+        for (;;) {
+            cell = &_cells_[pos & _mask_];
+            size_t seq = cell->_seq_.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueue_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_.load(memory_order_relaxed);
+            }
+        }
+        new (cell->_data_) T(std::move(element));
+        cell->_seq_.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    void push(T&& element) {
+        while (!try_push(std::move(element)))
+            std::this_thread::yield();
+    }
+
+    // no lock to share, so simply one by one
+    void push_bulk(T* elements, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            push(std::move(elements[i]));
+    }
+
+    // stops at the first element the queue is full for, returns how many
+    size_t try_push_bulk(T* elements, size_t n) {
+        size_t i = 0;
+        while (i < n && try_push(std::move(elements[i])))
+            ++i;
+        return i;
+    }
+
+    bool pop(T& element) {
+        Cell* cell;
+        size_t pos = _dequeue_.load(memory_order_relaxed);
+        for (;;) {
+            cell = &_cells_[pos & _mask_];
+            size_t seq = cell->_seq_.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeue_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeue_.load(memory_order_relaxed);
+            }
+        }
+        element = std::move(*cell->element());
+        cell->element()->~T();
+        cell->_seq_.store(pos + _mask_ + 1, memory_order_release);
+        return true;
+    }
+
+    // no lock to share, so simply one by one
+    size_t pop_bulk(T* elements, size_t max) {
+        size_t n = 0;
+        while (n < max && pop(elements[n]))
+            ++n;
+        return n;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t size() const {
+        size_t d = _dequeue_.load(memory_order_acquire);
+        size_t e = _enqueue_.load(memory_order_acquire);
+        return e > d ? e - d : 0;
+    }
+
+};
+
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * lockfree_queue_test.cpp
+ *
+ * Testing Lockfree_Queue, the bounded ring: its empty and full boundaries,
+ * and that many producers and consumers through it lose and duplicate no
+ * element, each consumer seeing the elements of each producer in order.
+ * pop() is its non-blocking pop, false when the ring is empty.
+ *
+ */
+
+#include <cstdio>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "lockfree_queue.h"
+
+
+using std::atomic;
+using std::thread;
+using std::vector;
+
+
+void check(char const* what, bool ok) {
+    std::fprintf(stderr, "[%s] %s\n", ok ? "ok" : "FAILED", what);
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    // a capacity not a power of two is rounded up to one
+    Lockfree_Queue<unsigned> q(5);
+    unsigned x = 0;
+
+    check("pop of an empty ring", !q.pop(x) && q.empty());
+    unsigned pushed = 0;
+    for (unsigned i = 0; i < 16; ++i) {
+        unsigned y = i;
+        if (!q.try_push(std::move(y)))
+            break;
+        ++pushed;
+    }
+    std::fprintf(stderr, "capacity 5: %u elements pushed before full\n", pushed);
+    check("try_push of a full ring", pushed == 8 && q.size() == 8);
+    check("pop of a full ring", q.pop(x) && x == 0);
+    unsigned y = 8;
+    check("try_push after a pop", q.try_push(std::move(y)) && q.size() == 8);
+    bool ordered = true;
+    for (unsigned i = 1; i < 9; ++i)
+        ordered = q.pop(x) && x == i && ordered;
+    check("drained in order", ordered);
+    check("pop of a drained ring", !q.pop(x) && q.empty());
+
+    // a small ring, so that producers find it full and wrap it many times
+    unsigned const PRODUCERS = 4;
+    unsigned const CONSUMERS = 4;
+    unsigned const ELEMENTS = 200000;       // of each producer
+    Lockfree_Queue<unsigned> r(64);
+    atomic<unsigned> popped(0);
+    vector<vector<unsigned>> seen(CONSUMERS);
+    vector<thread> threads;
+    for (unsigned p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([p, &r] {
+            for (unsigned i = 0; i < ELEMENTS; ++i)
+                r.push(p * ELEMENTS + i);
+        });
+    }
+    for (unsigned c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([c, &r, &popped, &seen] {
+            unsigned element;
+            while (popped.load(memory_order_relaxed) < PRODUCERS * ELEMENTS) {
+                if (r.pop(element)) {
+                    seen[c].push_back(element);
+                    popped.fetch_add(1, memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (thread& t : threads)
+        t.join();
+
+    vector<unsigned> counts(PRODUCERS * ELEMENTS, 0);
+    bool fifo = true;
+    for (vector<unsigned> const& s : seen) {
+        vector<long> last(PRODUCERS, -1);
+        for (unsigned element : s) {
+            ++counts[element];
+            long i = element % ELEMENTS;
+            fifo = i > last[element / ELEMENTS] && fifo;
+            last[element / ELEMENTS] = i;
+        }
+    }
+    size_t lost = 0;
+    size_t duplicated = 0;
+    for (unsigned n : counts) {
+        if (n == 0)
+            ++lost;
+        else if (n > 1)
+            duplicated += n - 1;
+    }
+    std::fprintf(stderr, "%u producers, %u consumers: %zu lost, %zu duplicated of %u\n",
+                 PRODUCERS, CONSUMERS, lost, duplicated, PRODUCERS * ELEMENTS);
+    check("no element lost or duplicated", !lost && !duplicated && r.empty());
+    check("elements of a producer in order", fifo);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ * lockfree_shared_pool.h
+ *
+ * A simple thread pool using a shared task queue among worker threads,
+ * accepting callables as tasks.
+ *
+ * The shared task queue is a bounded lock-free ring, so submit() waits while
+ * it is full.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKFREE_SHARED_POOL_H
+#define LOCKFREE_SHARED_POOL_H
+
+
+#include "lockfree_queue.h"
+#include "thread_pool.h"
+
+
+typedef Thread_Pool<Shared_Queue<Lockfree_Queue<Task_Wrapper>>,
+                    Random_Placement,
+                    No_Steal,
+                    Park_Idle,
+                    Direct_Front> Lockfree_Shared_Pool;
+
+
+#endif
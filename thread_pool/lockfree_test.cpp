@@ -0,0 +1,34 @@
+/*
+ * lockfree_test.cpp
+ *
+ * Testing Thread_Pool, and that callables kept inline which are not
+ * trivially copyable pass through its lock-free deques intact.
+ *
+ */
+
+#include <cstdio>
+
+#include <memory>
+
+#include "lockfree_mutual_pool.h"
+#include "producers_harness.h"
+
+
+int main() {
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Lockfree_Mutual_Pool<>>("lockfree_mutual");
+
+    std::shared_ptr<unsigned> shared(new unsigned(1));
+    atomic<unsigned> sum(0);
+    {
+        Lockfree_Mutual_Pool<> pool;
+        for (unsigned i = 0; i < 10000; ++i)
+            pool.post([shared, &sum] { sum.fetch_add(*shared, memory_order_relaxed); });
+    }
+    std::fprintf(stderr, "\n%u of 10000 tasks holding a shared_ptr run, %ld owners left.\n",
+                 sum.load(), shared.use_count());
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
+
@@ -0,0 +1,108 @@
+/*
+ * lockwise_deque.h
+ *
+ * A generic deque supporting concurrency access.
+ *   - nonblocking
+ *   - using spin-lock mutex without condition_variable, the mutex is a
+ *     policy from spinlock_mutex.h, TTAS_Mutex by default
+ *   - element type is movable
+ *
+ */
+
+#ifndef LOCKWISE_DEQUE_H
+#define LOCKWISE_DEQUE_H
+
+
+#include <algorithm>
+#include <mutex>
+#include <deque>
+
+#include "spinlock_mutex.h"
+
+
+using std::lock_guard;
+using std::deque;
+
+
+template<class T, class Mutex = TTAS_Mutex>
+class Lockwise_Deque {
+
+  private:
+    Mutex mutable _m_;
+    deque<T> _q_;
+
+  public:
+    void push(T&& element) {
+        lock_guard<Mutex> lk(_m_);
+        _q_.push_back(std::move(element));
+    }
+
+    // n elements moved in under one lock
+    void push_bulk(T* elements, size_t n) {
+        lock_guard<Mutex> lk(_m_);
+        for (size_t i = 0; i < n; ++i)
+            _q_.push_back(std::move(elements[i]));
+    }
+
+    void push_front(T&& element) {
+        lock_guard<Mutex> lk(_m_);
+        _q_.push_front(std::move(element));
+    }
+
+    bool pop(T& element) {
+        lock_guard<Mutex> lk(_m_);
+        if (_q_.empty())
+            return false;
+        element = std::move(_q_.front());
+        _q_.pop_front();
+        return true;
+    }
+
+    // moves out no more than max elements from the front under one lock,
+    // returns how many
+    size_t pop_bulk(T* elements, size_t max) {
+        lock_guard<Mutex> lk(_m_);
+        size_t n = 0;
+        for (; n < max && !_q_.empty(); ++n) {
+            elements[n] = std::move(_q_.front());
+            _q_.pop_front();
+        }
+        return n;
+    }
+
+    // moves out half the elements, rounded up, but no more than max, from
+    // the front under one lock, returns how many; for a thief
+    size_t pop_half(T* elements, size_t max) {
+        lock_guard<Mutex> lk(_m_);
+        size_t n = 0;
+        for (size_t half = std::min((_q_.size() + 1) / 2, max); n < half; ++n) {
+            elements[n] = std::move(_q_.front());
+            _q_.pop_front();
+        }
+        return n;
+    }
+
+    bool pull(T& element) {
+        lock_guard<Mutex> lk(_m_);
+        if (_q_.empty())
+            return false;
+        element = std::move(_q_.back());
+        _q_.pop_back();
+        return true;
+    }
+
+    bool empty() const {
+        lock_guard<Mutex> lk(_m_);
+        return _q_.empty();
+    }
+
+    size_t size() const {
+        lock_guard<Mutex> lk(_m_);
+        return _q_.size();
+    }
+
+};
+
+
+#endif
+
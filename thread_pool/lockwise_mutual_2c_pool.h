@@ -0,0 +1,35 @@
+/*
+ * lockwise_mutual_2c_pool.h
+ *
+ * A simple thread pool using a mutual task queue within each worker thread,
+ * accepting callables as tasks.
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * A worker pops its own tasks at the front and steals at the back.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKWISE_MUTUAL_2C_POOL_H
+#define LOCKWISE_MUTUAL_2C_POOL_H
+
+
+#include "lockwise_deque.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Lockwise_Mutual_2c_Pool = Thread_Pool<Worker_Queues<Lockwise_Deque<Task_Wrapper>>,
+                                            Placement,
+                                            Steal<Front_End, Back_End>,
+                                            Park_Idle,
+                                            Direct_Front>;
+
+
+#endif
@@ -0,0 +1,37 @@
+/*
+ * lockwise_mutual_2e_pool.h
+ *
+ * A simple thread pool using a mutual task queue within each worker thread,
+ * accepting callables as tasks.
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * A worker pulls its own tasks at the back and steals at the front, from
+ * the nearest workers first: its SMT siblings, those sharing its L3, those
+ * on its NUMA node, and the remote ones last.  Workers are pinned to CPUs.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKWISE_MUTUAL_2E_POOL_H
+#define LOCKWISE_MUTUAL_2E_POOL_H
+
+
+#include "lockwise_deque.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Lockwise_Mutual_2e_Pool = Thread_Pool<Worker_Queues<Lockwise_Deque<Task_Wrapper>>,
+                                            Placement,
+                                            Steal<Back_End, Front_End, Topology_Order>,
+                                            Park_Idle,
+                                            Direct_Front>;
+
+
+#endif
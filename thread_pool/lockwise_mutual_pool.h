@@ -0,0 +1,33 @@
+/*
+ * lockwise_mutual_pool.h
+ *
+ * A simple thread pool using a mutual task queue within each worker thread,
+ * accepting callables as tasks.
+ *
+ * Mutual task queue means its tasks would be popped into the other worker
+ * threads.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKWISE_MUTUAL_POOL_H
+#define LOCKWISE_MUTUAL_POOL_H
+
+
+#include "lockwise_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Lockwise_Mutual_Pool = Thread_Pool<Worker_Queues<Lockwise_Queue<Task_Wrapper>>,
+                                         Placement,
+                                         Steal<Front_End, Front_End>,
+                                         Park_Idle,
+                                         Direct_Front>;
+
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * lockwise_shared_pool.h
+ *
+ * A simple thread pool using a shared task queue among worker threads,
+ * accepting callables as tasks.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * With a batch size over 1, a worker takes a batch of tasks by one lock of
+ * the queue and runs them all before coming back.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKWISE_SHARED_POOL_H
+#define LOCKWISE_SHARED_POOL_H
+
+
+#include "lockwise_queue.h"
+#include "thread_pool.h"
+
+
+typedef Thread_Pool<Shared_Queue<Lockwise_Queue<Task_Wrapper>>,
+                    Random_Placement,
+                    No_Steal,
+                    Park_Idle,
+                    Direct_Front> Lockwise_Shared_Pool;
+
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * lockwise_test.cpp
+ *
+ * Testing Thread_Pool.
+ *
+ */
+
+#include <cstdio>
+
+#include "lockwise_mutual_2a_pool.h"
+#include "producers_harness.h"
+
+
+int main() {
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Lockwise_Mutual_2a_Pool<>>("lockwise_mutual_2a");
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
+
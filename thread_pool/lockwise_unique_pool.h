@@ -0,0 +1,30 @@
+/*
+ * lockwise_unique_pool.h
+ *
+ * A simple thread pool using a unique task queue within each worker thread,
+ * accepting callables as tasks.
+ *
+ * Idle workers yield for a while (the spin budget) and then park until a
+ * task is submitted.
+ *
+ * An alias of Thread_Pool, see thread_pool.h.
+ *
+ */
+
+#ifndef LOCKWISE_UNIQUE_POOL_H
+#define LOCKWISE_UNIQUE_POOL_H
+
+
+#include "lockwise_queue.h"
+#include "thread_pool.h"
+
+
+template<class Placement = Random_Placement>
+using Lockwise_Unique_Pool = Thread_Pool<Worker_Queues<Lockwise_Queue<Task_Wrapper>>,
+                                         Placement,
+                                         No_Steal,
+                                         Park_Idle,
+                                         Direct_Front>;
+
+
+#endif
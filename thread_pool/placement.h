@@ -0,0 +1,69 @@
+/*
+ * placement.h
+ *
+ * Policies choosing the worker queue a submitted task goes into.
+ *   - Random_Placement: a random queue from a per-thread xorshift generator
+ *   - Round_Robin_Placement: each submitting thread cycles over the queues
+ *   - Two_Choice_Placement: the shorter one of two random queues
+ *
+ * None of them shares any state among submitting threads, unlike std::rand()
+ * which takes a process-wide lock in glibc.
+ *
+ */
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+
+#include <cstdint>
+
+#include <functional>
+#include <thread>
+
+
+// xorshift32, seeded differently in every thread
+inline uint32_t fast_rand() {
+    thread_local uint32_t state =
+        static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+
+// maps a random number onto [0, n) without a division
+inline unsigned fast_rand(unsigned n) {
+    return static_cast<unsigned>((static_cast<uint64_t>(fast_rand()) * n) >> 32);
+}
+
+
+struct Random_Placement {
+    template<class Queue>
+    unsigned operator()(Queue const*, unsigned size) const {
+        return fast_rand(size);
+    }
+};
+
+
+struct Round_Robin_Placement {
+    template<class Queue>
+    unsigned operator()(Queue const*, unsigned size) const {
+        // start at a random queue so that submitters do not move in step
+        thread_local unsigned next = fast_rand();
+        return next++ % size;
+    }
+};
+
+
+struct Two_Choice_Placement {
+    template<class Queue>
+    unsigned operator()(Queue const* queues, unsigned size) const {
+        unsigned a = fast_rand(size);
+        unsigned b = fast_rand(size);
+        return queues[b].size() < queues[a].size() ? b : a;
+    }
+};
+
+
+#endif
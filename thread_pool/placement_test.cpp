@@ -0,0 +1,36 @@
+/*
+ * placement_test.cpp
+ *
+ * Comparing submit throughput of Thread_Pool under every placement policy.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include "lockwise_unique_pool.h"
+#include "producers_harness.h"
+
+
+// the placement used before, as the baseline
+struct Std_Rand_Placement {
+    template<class Queue>
+    unsigned operator()(Queue const*, unsigned size) const {
+        return std::rand() % size;
+    }
+};
+
+
+int main() {
+    std::srand(std::time(0));
+
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Lockwise_Unique_Pool<Std_Rand_Placement>>("std::rand()");
+    run_producers<Lockwise_Unique_Pool<Random_Placement>>("xorshift");
+    run_producers<Lockwise_Unique_Pool<Round_Robin_Placement>>("round-robin");
+    run_producers<Lockwise_Unique_Pool<Two_Choice_Placement>>("two-choice");
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * pool_config.h
+ *
+ * Settings of a Thread_Pool fixed at its construction.
+ *
+ */
+
+#ifndef POOL_CONFIG_H
+#define POOL_CONFIG_H
+
+
+#include <cstdint>
+
+#include "topology.h"
+
+
+struct Task_Latency;
+
+
+struct Pool_Config {
+    // 0 for one a CPU of _affinity_, or thread::hardware_concurrency() if
+    // the workers are not pinned
+    unsigned _workersize_ = 0;
+    // yields of an idle worker before it parks
+    unsigned _spinbudget_ = 64;
+    // nanoseconds an Adaptive_Idle worker spins, and then yields, at most
+    // before it parks, see idle.h
+    uint64_t _spinlimit_ = 50000;
+    // tasks a worker takes at a time from a queue others pop as well, a
+    // queue nobody else pops is always drained in batches
+    unsigned _batchsize_ = 1;
+    // the CPUs workers are pinned to when they start, see topology.h; a
+    // pool stealing by topology takes NONE as MASK
+    Affinity _affinity_;
+    // if set, workers record task latencies and the pool merges them here
+    // when it is destructed, see latency.h
+    Task_Latency* _latency_ = nullptr;
+};
+
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * post_test.cpp
+ *
+ * Comparing submit() with post() and execute() for tasks whose results are
+ * never waited for, and checking the exception handler of execute() and
+ * that post() and execute() take callables which are movable only.
+ *
+ */
+
+#include <cstdio>
+
+#include <memory>
+#include <stdexcept>
+
+#include "lockwise_mutual_pool.h"
+#include "producers_harness.h"
+
+
+void check_handler() {
+    atomic<unsigned> caught(0);
+    {
+        Lockwise_Mutual_Pool<> pool;
+        pool.set_exception_handler([&caught](exception_ptr) {
+            caught.fetch_add(1, memory_order_relaxed);
+        });
+        for (unsigned i = 0; i < 100; ++i)
+            pool.execute([i] {
+                if (i % 2)
+                    throw std::runtime_error("missed");
+            });
+    }
+    std::fprintf(stderr, "\n%u of 50 exceptions caught by the handler.\n", caught.load());
+}
+
+
+void check_move_only() {
+    atomic<unsigned> sum(0);
+    {
+        Lockwise_Mutual_Pool<> pool;
+        for (unsigned i = 0; i < 50; ++i) {
+            std::unique_ptr<unsigned> p(new unsigned(1));
+            pool.post([&sum, p = std::move(p)] { sum.fetch_add(*p, memory_order_relaxed); });
+            std::unique_ptr<unsigned> q(new unsigned(1));
+            pool.execute([&sum, q = std::move(q)] { sum.fetch_add(*q, memory_order_relaxed); });
+        }
+    }
+    std::fprintf(stderr, "\n%u of 100 movable only tasks run.\n", sum.load());
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Lockwise_Mutual_Pool<>>("submit");
+    run_producers<Lockwise_Mutual_Pool<>>("post/execute", true);
+    check_handler();
+    check_move_only();
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
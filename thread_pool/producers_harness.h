@@ -0,0 +1,173 @@
+/*
+ * producers_harness.h
+ *
+ * The harness of the pool tests: ten producers submit into a Thread_Pool
+ * for half a minute, each a kind of callable of archery.h, and the count
+ * submitted is printed once the pool has run them all.
+ *   - with post, producers of tasks whose results are never waited for use
+ *     post() and execute() instead of submit()
+ *
+ */
+
+#ifndef PRODUCERS_HARNESS_H
+#define PRODUCERS_HARNESS_H
+
+
+#include <cstdio>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <ratio>
+#include <thread>
+
+#include "archery.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::ratio;
+using std::thread;
+
+
+template<class Pool>
+void run_producers(char const* name, bool post = false) {
+    duration<double, ratio<60,1>> PERIOD(0.5);
+    size_t counter[11] = {};
+    time_point<steady_clock> start;
+    atomic<bool> go(false);
+
+    {
+        Pool pool;
+
+        thread t1([PERIOD, post, &counter, &start, &go, &pool] {        // test free function of void()
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            void (*task)() = shoot;
+            for (counter[1] = 0; steady_clock::now() - start <= PERIOD; ++counter[1]) {
+                if (post) pool.post(task); else pool.submit(task);
+                std::this_thread::yield();
+            }
+        });
+
+        thread t2([PERIOD, &counter, &start, &go, &pool] {        // test free function of bool(size_t)
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            bool (*task)(size_t) = shoot;
+            for (counter[2] = 0; steady_clock::now() - start <= PERIOD; ++counter[2]) {
+                Future<bool> r = pool.submit(std::bind(task, counter[2]));
+                std::this_thread::yield();
+            }
+        });
+
+        thread t3([PERIOD, post, &counter, &start, &go, &pool] {        // test lambda of void()
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            for (counter[3] = 0; steady_clock::now() - start <= PERIOD; ++counter[3]) {
+                if (post) pool.post(shootAnarrow); else pool.submit(shootAnarrow);
+                std::this_thread::yield();
+            }
+        });
+
+        thread t4([PERIOD, &counter, &start, &go, &pool] {        // test lambda of bool(size_t)
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            for (counter[4] = 0; steady_clock::now() - start <= PERIOD; ++counter[4]) {
+                Future<bool> r = pool.submit(std::bind(shootNarrows, counter[4]));
+                std::this_thread::yield();
+            }
+        });
+
+        thread t5([PERIOD, post, &counter, &start, &go, &pool] {        // test functor of void()
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            Archer hoyt;
+            for (counter[5] = 0; steady_clock::now() - start <= PERIOD; ++counter[5]) {
+                if (post) pool.post(hoyt); else pool.submit(hoyt);
+                std::this_thread::yield();
+            }
+        });
+
+        thread t6([PERIOD, &counter, &start, &go, &pool] {        // test functor of bool(size_t)
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            Archer hoyt;
+            for (counter[6] = 0; steady_clock::now() - start <= PERIOD; ++counter[6]) {
+                Future<bool> r = pool.submit(std::bind(hoyt, counter[6]));
+                std::this_thread::yield();
+            }
+        });
+
+        thread t7([PERIOD, post, &counter, &start, &go, &pool] {        // test member function of void()
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            Archer hoyt;
+            for (counter[7] = 0; steady_clock::now() - start <= PERIOD; ++counter[7]) {
+                if (post) pool.post(std::bind<void(Archer::*)()>(&Archer::shoot, &hoyt));
+                else pool.submit(std::bind<void(Archer::*)()>(&Archer::shoot, &hoyt));
+                std::this_thread::yield();
+            }
+        });
+
+        thread t8([PERIOD, &counter, &start, &go, &pool] {        // test member function of bool(size_t)
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            Archer hoyt;
+            for (counter[8] = 0; steady_clock::now() - start <= PERIOD; ++counter[8]) {
+                Future<bool> r = pool.submit(std::bind<bool(Archer::*)(size_t)>(&Archer::shoot, &hoyt, counter[8]));
+                std::this_thread::yield();
+            }
+        });
+
+        thread t9([PERIOD, post, &counter, &start, &go, &pool] {        // test std::function<> of void()
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            std::function<void()> task = static_cast<void(*)()>(shoot);
+            for (counter[9] = 0; steady_clock::now() - start <= PERIOD; ++counter[9]) {
+                if (post) pool.execute(task); else pool.submit(task);
+                std::this_thread::yield();
+            }
+        });
+
+        thread t10([PERIOD, &counter, &start, &go, &pool] {        // test std::function<> of bool(size_t)
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            std::function<bool(size_t)> task = static_cast<bool(*)(size_t)>(shoot);
+            for (counter[10] = 0; steady_clock::now() - start <= PERIOD; ++counter[10]) {
+                Future<bool> r = pool.submit(std::bind(task, counter[10]));
+                std::this_thread::yield();
+            }
+        });
+
+        std::this_thread::sleep_for(milliseconds(1000));
+        start = steady_clock::now();
+        go.store(true, memory_order_release);
+
+        t10.join();
+        t9.join();
+        t8.join();
+        t7.join();
+        t6.join();
+        t5.join();
+        t4.join();
+        t3.join();
+        t2.join();
+        t1.join();
+
+    }
+
+    for (unsigned i = 1; i < 11; ++i)
+        counter[0] += counter[i];
+    time_point<steady_clock> end = steady_clock::now();
+    std::fprintf(stderr, "\n[%s] %zu tasks submitted, %.0f per second, took %.3f seconds.\n",
+                 name, counter[0], counter[0] / duration<double>(PERIOD).count(),
+                 duration<double>(end - start).count());
+}
+
+
+#endif
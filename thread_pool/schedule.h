@@ -0,0 +1,75 @@
+/*
+ * schedule.h
+ *
+ * Send schedules of an open-loop load generator, which submits tasks when
+ * they are due whatever the state of the pool, unlike the closed-loop
+ * producers of the other harnesses.
+ *   - poisson_schedule() draws exponential gaps at a given rate
+ *   - read_schedule() reads a trace, an offset in nanoseconds a line, and
+ *     sorts it, so its last offset is its period
+ *   - wait_until() sleeps, then yields, up to a time on latency_clock()
+ *
+ * Late tasks are still sent, and Thread_Pool::post_at() stamps them with
+ * when they were due, so their latencies include the time lost, i.e. they
+ * are corrected for coordinated omission.
+ *
+ */
+
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "latency.h"
+
+
+using std::vector;
+
+
+// offsets from the start in nanoseconds, rate in tasks per second
+inline vector<uint64_t> poisson_schedule(double rate, double seconds, unsigned seed) {
+    vector<uint64_t> offsets;
+    std::mt19937_64 random(seed);
+    std::exponential_distribution<double> gap(rate / 1e9);
+    for (double t = gap(random); t < seconds * 1e9; t += gap(random))
+        offsets.push_back(static_cast<uint64_t>(t));
+    return offsets;
+}
+
+
+// empty if the trace cannot be read
+inline vector<uint64_t> read_schedule(char const* path) {
+    vector<uint64_t> offsets;
+    FILE* in = std::fopen(path, "r");
+    if (!in)
+        return offsets;
+    unsigned long long offset;
+    while (std::fscanf(in, "%llu", &offset) == 1)
+        offsets.push_back(offset);
+    std::fclose(in);
+    std::sort(offsets.begin(), offsets.end());
+    return offsets;
+}
+
+
+// sleeps while the time is far enough for the scheduler to be trusted
+inline void wait_until(uint64_t ns) {
+    uint64_t const SLACK = 100000;
+    for (uint64_t now = latency_clock(); now < ns; now = latency_clock()) {
+        if (ns - now > SLACK)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(ns - now - SLACK));
+        else
+            std::this_thread::yield();
+    }
+}
+
+
+#endif
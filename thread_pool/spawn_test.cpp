@@ -0,0 +1,102 @@
+/*
+ * spawn_test.cpp
+ *
+ * Timing a divide-and-conquer sum in Thread_Pool, each task splitting its
+ * range among two children it submits until the range is small, on pools
+ * which keep the children of a worker with it and on one which does not,
+ * and checking the sum, so that a child lost or run twice fails the test.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "lockfree_mutual_pool.h"
+#include "lockwise_mutual_2b_pool.h"
+#include "lockwise_unique_pool.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::vector;
+
+
+size_t const LEAF_SIZE = 4096;
+
+
+template<class Pool>
+struct Sum {
+    Pool* _pool_;
+    unsigned const* _data_;
+    atomic<unsigned long long>* _sum_;
+    atomic<size_t>* _pending_;      // leaves not yet summed
+    size_t _first_;
+    size_t _last_;
+
+    void operator()() const {
+        if (_last_ - _first_ <= LEAF_SIZE) {
+            unsigned long long s = std::accumulate(_data_ + _first_, _data_ + _last_, 0ull);
+            _sum_->fetch_add(s, memory_order_relaxed);
+            _pending_->fetch_sub(1, memory_order_release);
+            return;
+        }
+        size_t middle = _first_ + (_last_ - _first_) / 2;
+        Sum left = *this;
+        left._last_ = middle;
+        Sum right = *this;
+        right._first_ = middle;
+        _pool_->post(right);
+        left();
+    }
+};
+
+
+template<class Pool>
+void run(char const* name, vector<unsigned> const& data) {
+    size_t leaves = 1;
+    while (data.size() / leaves > LEAF_SIZE)
+        leaves *= 2;
+    atomic<unsigned long long> sum(0);
+    atomic<size_t> pending(leaves);
+
+    Pool pool;
+    time_point<steady_clock> start = steady_clock::now();
+    time_point<steady_clock> deadline = start + seconds(60);
+    pool.post(Sum<Pool>{&pool, data.data(), &sum, &pending, 0, data.size()});
+    while (pending.load(memory_order_acquire) && steady_clock::now() < deadline)
+        std::this_thread::yield();
+    time_point<steady_clock> end = steady_clock::now();
+
+    // data is 0, 1, ..., n - 1
+    unsigned long long n = data.size();
+    bool ok = !pending.load(memory_order_acquire) && sum.load() == n * (n - 1) / 2;
+    std::fprintf(stderr, "[%s] %s: sum %llu of %zu leaves in %.3f ms\n", ok ? "ok" : "FAILED",
+                 name, sum.load(), leaves, duration<double, std::milli>(end - start).count());
+    if (!ok)
+        std::_Exit(EXIT_FAILURE);       // children may be left running
+}
+
+
+int main() {
+    vector<unsigned> data(1 << 24);
+    std::iota(data.begin(), data.end(), 0u);
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    for (unsigned i = 0; i < 3; ++i) {
+        run<Lockwise_Mutual_2b_Pool<>>("lockwise_mutual_2b", data);
+        run<Lockfree_Mutual_Pool<>>("lockfree_mutual", data);
+        run<Lockwise_Unique_Pool<>>("lockwise_unique", data);
+    }
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * spinlock_mutex.h
+ *
+ * Spin-lock mutexes to be used as the lock policy of Lockwise_Queue and
+ * Lockwise_Deque, all meeting BasicLockable.
+ *   - Spinlock_Mutex: test-and-set, the lock used before, as the baseline
+ *   - TTAS_Mutex: test-and-test-and-set with exponential backoff
+ *   - Ticket_Mutex: a FIFO ticket lock
+ *   - MCS_Mutex: a FIFO queue lock, every waiter spins on its own node
+ *
+ * Waiters pause the CPU between polls and yield once the backoff reaches
+ * its limit, so a holder which was preempted still gets its time slice.
+ * Ticket_Mutex and MCS_Mutex hand the lock over in arrival order, and
+ * nobody starves under contention.  But when threads outnumber cores the
+ * next in line may be preempted, and everybody behind it waits as well.
+ *
+ */
+
+#ifndef SPINLOCK_MUTEX_H
+#define SPINLOCK_MUTEX_H
+
+
+#include <atomic>
+#include <thread>
+
+
+using std::atomic;
+using std::atomic_flag;
+using std::memory_order_acq_rel;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+
+class Backoff {
+
+  private:
+    static constexpr unsigned LIMIT = 1024;
+
+    unsigned _pauses_;
+
+  public:
+    Backoff() : _pauses_(1) {}
+
+    void pause() {
+        if (_pauses_ <= LIMIT) {
+            for (unsigned i = 0; i < _pauses_; ++i)
+                cpu_relax();
+            _pauses_ <<= 1;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+};
+
+
+class Spinlock_Mutex {
+
+  private:
+    atomic_flag _af_;
+
+  public:
+    Spinlock_Mutex() : _af_(false) {}
+
+    void lock() {
+        while (_af_.test_and_set(memory_order_acquire));
+    }
+
+    void unlock() {
+        _af_.clear(memory_order_release);
+    }
+
+};
+
+
+class TTAS_Mutex {
+
+  private:
+    atomic<bool> _locked_;
+
+  public:
+    TTAS_Mutex() : _locked_(false) {}
+
+    void lock() {
+        Backoff backoff;
+        // writing only when the lock looks free
+        while (_locked_.load(memory_order_relaxed) || _locked_.exchange(true, memory_order_acquire))
+            backoff.pause();
+    }
+
+    void unlock() {
+        _locked_.store(false, memory_order_release);
+    }
+
+};
+
+
+class Ticket_Mutex {
+
+  private:
+    atomic<unsigned> _next_;
+    atomic<unsigned> _serving_;
+
+  public:
+    Ticket_Mutex() : _next_(0), _serving_(0) {}
+
+    void lock() {
+        unsigned ticket = _next_.fetch_add(1, memory_order_relaxed);
+        Backoff backoff;
+        while (_serving_.load(memory_order_acquire) != ticket)
+            backoff.pause();
+    }
+
+    void unlock() {
+        _serving_.store(_serving_.load(memory_order_relaxed) + 1, memory_order_release);
+    }
+
+};
+
+
+class MCS_Mutex {
+
+  private:
+    struct Node {
+        atomic<Node*> _next_;
+        atomic<bool> _waiting_;
+    };
+
+    // Locks are released in the reverse order of taking, as lock_guard
+    // does, so the nodes of a thread form a stack.
+    static constexpr unsigned DEPTH = 16;
+
+    struct Nodes {
+        Node _nodes_[DEPTH];
+        unsigned _top_ = 0;
+    };
+
+    static Nodes& nodes() {
+        thread_local Nodes n;
+        return n;
+    }
+
+    atomic<Node*> _tail_;
+
+  public:
+    MCS_Mutex() : _tail_(nullptr) {}
+
+    void lock() {
+        Nodes& s = nodes();
+        Node* me = &s._nodes_[s._top_++];
+        me->_next_.store(nullptr, memory_order_relaxed);
+        me->_waiting_.store(true, memory_order_relaxed);
+        Node* prev = _tail_.exchange(me, memory_order_acq_rel);
+        if (prev) {
+            prev->_next_.store(me, memory_order_release);
+            Backoff backoff;
+            while (me->_waiting_.load(memory_order_acquire))
+                backoff.pause();
+        }
+    }
+
+    void unlock() {
+        Nodes& s = nodes();
+        Node* me = &s._nodes_[--s._top_];
+        Node* next = me->_next_.load(memory_order_acquire);
+        if (!next) {
+            Node* expected = me;
+            if (_tail_.compare_exchange_strong(expected, nullptr, memory_order_release, memory_order_relaxed))
+                return;
+            // a successor is linking itself in
+            Backoff backoff;
+            while (!(next = me->_next_.load(memory_order_acquire)))
+                backoff.pause();
+        }
+        next->_waiting_.store(false, memory_order_release);
+    }
+
+};
+
+
+#endif
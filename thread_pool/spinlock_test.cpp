@@ -0,0 +1,85 @@
+/*
+ * spinlock_test.cpp
+ *
+ * Comparing the spin-lock mutexes of Lockwise_Queue from 1 to 64 threads,
+ * by throughput and by fairness, i.e. the fewest operations done by one
+ * thread against the most.
+ *
+ */
+
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "lockwise_queue.h"
+#include "spinlock_mutex.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::thread;
+using std::vector;
+
+
+template<class Mutex>
+void run(char const* name, unsigned threadsize) {
+    duration<double> PERIOD(0.2);
+    Lockwise_Queue<size_t, Mutex> queue;
+    vector<size_t> counter(threadsize, 0);
+    vector<thread> threads;
+    time_point<steady_clock> start;
+    atomic<bool> go(false);
+
+    for (unsigned i = 0; i < threadsize; ++i) {
+        threads.emplace_back([PERIOD, i, &queue, &counter, &start, &go] {
+            while (!go.load(memory_order_acquire))
+                std::this_thread::yield();
+            size_t n = 0;
+            size_t element;
+            for (; steady_clock::now() - start <= PERIOD; ++n) {
+                queue.push(std::move(n));
+                queue.pop(element);
+            }
+            counter[i] = n;
+        });
+    }
+    start = steady_clock::now();
+    go.store(true, memory_order_release);
+    for (thread& t : threads)
+        t.join();
+
+    size_t total = 0;
+    for (size_t n : counter)
+        total += n;
+    size_t least = *std::min_element(counter.begin(), counter.end());
+    size_t most = *std::max_element(counter.begin(), counter.end());
+    std::fprintf(stderr, "[%-8s %2u threads] %10.0f push/pop pairs per second, fairness %.3f\n",
+                 name, threadsize, total / PERIOD.count(), most ? static_cast<double>(least) / most : 0.0);
+}
+
+
+template<class Mutex>
+void run(char const* name) {
+    for (unsigned threadsize = 1; threadsize <= 64; threadsize *= 2)
+        run<Mutex>(name, threadsize);
+    std::fprintf(stderr, "\n");
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    run<Spinlock_Mutex>("TAS");
+    run<TTAS_Mutex>("TTAS");
+    run<Ticket_Mutex>("ticket");
+    run<MCS_Mutex>("MCS");
+
+    std::fprintf(stderr, "Bye...\n");
+    return 0;
+}
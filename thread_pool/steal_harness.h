@@ -0,0 +1,75 @@
+/*
+ * steal_harness.h
+ *
+ * A load for comparing ways of stealing of Thread_Pool, shared by
+ * steal_test.cpp and topology_test.cpp: every task is submitted into the
+ * first queue, which the other workers have to steal from, and a run
+ * reports the time taken and the counts of the thieves summed.
+ *
+ */
+
+#ifndef STEAL_HARNESS_H
+#define STEAL_HARNESS_H
+
+
+#include <cstdio>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "lockwise_deque.h"
+#include "thread_pool.h"
+#include "workload.h"
+
+
+using std::atomic;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+using std::memory_order_acquire;
+using std::memory_order_release;
+
+
+// every task into the first queue
+struct First_Placement {
+    template<class Queue>
+    unsigned operator()(Queue const*, unsigned) const {
+        return 0;
+    }
+};
+
+
+// kernel as parsed by parse_workload()
+template<class StealPolicy>
+void run_steal(char const* name, char const* kernel, Pool_Config const& config) {
+    unsigned const TASKS = 100000;
+    Workload workload;
+    parse_workload(kernel, workload);
+    prepare_workload(workload);
+    atomic<unsigned> done(0);
+
+    Thread_Pool<Worker_Queues<Lockwise_Deque<Task_Wrapper>>, First_Placement, StealPolicy> pool(config);
+    time_point<steady_clock> start = steady_clock::now();
+    for (unsigned i = 0; i < TASKS; ++i)
+        pool.post([workload, &done] {
+            workload();
+            done.fetch_add(1, memory_order_release);
+        });
+    while (done.load(memory_order_acquire) < TASKS)
+        std::this_thread::yield();
+    double took = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    Steal_Stats total;
+    for (unsigned i = 0; i < pool.workersize(); ++i) {
+        Steal_Stats s = pool.steal_stats(i);
+        total._attempts_ += s._attempts_;
+        total._successes_ += s._successes_;
+        total._moved_ += s._moved_;
+    }
+    std::fprintf(stderr, "[%-12s] %u workers, %.3f ms, %zu attempts, %zu successes, %zu tasks moved\n",
+                 name, pool.workersize(), took, total._attempts_, total._successes_, total._moved_);
+}
+
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * steal_test.cpp
+ *
+ * Comparing the ways of stealing of Thread_Pool on a load all submitted
+ * into one queue, which the other workers have to steal from, by time taken
+ * and by the counts of the thieves.
+ *
+ */
+
+#include <cstdio>
+
+#include "steal_harness.h"
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    Pool_Config config;
+    config._workersize_ = 4;
+    run_steal<Steal<Back_End, Front_End, Fixed_Order, Steal_One>>("fixed, one", "spin:2000", config);
+    run_steal<Steal<Back_End, Front_End, Random_Order, Steal_One>>("random, one", "spin:2000", config);
+    run_steal<Steal<Back_End, Front_End, Fixed_Order, Steal_Half>>("fixed, half", "spin:2000", config);
+    run_steal<Steal<Back_End, Front_End, Random_Order, Steal_Half>>("random, half", "spin:2000", config);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
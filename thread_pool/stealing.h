@@ -0,0 +1,328 @@
+/*
+ * stealing.h
+ *
+ * Steal policies of Thread_Pool, telling which end of its own queue a worker
+ * takes tasks from, and whether and how it takes tasks from the queues of
+ * the others when its own is empty.
+ *   - No_Steal: a worker sticks to its own queue
+ *   - Steal<Own, Victim, Order, Amount>: a worker tries the other queues in
+ *     turn, Own and Victim being Front_End or Back_End
+ *       - Order: Random_Order, from a victim picked at random, so that idle
+ *         workers do not all converge on the same neighbour, Fixed_Order,
+ *         from the next queue on, or Topology_Order, SMT siblings first,
+ *         then workers sharing an L3, then those on the same NUMA node and
+ *         remote ones last, each group from one picked at random; it has
+ *         the pool pin its workers, see topology.h
+ *       - Amount: Steal_Half, half of the victim's queue in one go, one task
+ *         of which to run and the rest to go into the thief's queue, or
+ *         Steal_One, a task at a time
+ *
+ * Front_End is where tasks leave a queue in FIFO order, Back_End the other
+ * end of a deque, where the owner finds its latest tasks.  Only a front end
+ * is taken by halves, where the queue has pop_half().
+ *
+ * A task submitted by a worker of a stealing pool is given to the worker
+ * itself, at the end it takes from where the queue has a way to, so the
+ * children of a task run next on the core its data is hot in, while the
+ * oldest tasks are left to the thieves.
+ *
+ * Every thief counts its attempts, i.e. victims tried, its successes and
+ * the tasks it moved, see Thread_Pool::steal_stats().
+ *
+ */
+
+#ifndef STEALING_H
+#define STEALING_H
+
+
+#include <cstddef>
+
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "cache_line.h"
+#include "topology.h"
+
+
+using std::atomic;
+using std::memory_order_relaxed;
+using std::vector;
+
+
+struct Front_End {
+    template<class Queue, class T>
+    static void give(Queue& queue, T&& element) {
+        if constexpr (requires { queue.push_front(std::move(element)); })
+            queue.push_front(std::move(element));
+        else
+            queue.push(std::move(element));
+    }
+    // a blocking queue is taken from without waiting
+    template<class Queue, class T>
+    static bool take(Queue& queue, T& element) {
+        if constexpr (requires { queue.try_pop_bulk(&element, 1); })
+            return queue.try_pop_bulk(&element, 1);
+        else
+            return queue.pop(element);
+    }
+    template<class Queue, class T>
+    static size_t take_bulk(Queue& queue, T* elements, size_t max) {
+        if constexpr (requires { queue.try_pop_bulk(elements, max); })
+            return queue.try_pop_bulk(elements, max);
+        else
+            return max == 1 ? queue.pop(elements[0]) : queue.pop_bulk(elements, max);
+    }
+    template<class Queue, class T>
+    static size_t take_half(Queue& queue, T* elements, size_t max) {
+        if constexpr (requires { queue.pop_half(elements, max); })
+            return queue.pop_half(elements, max);
+        else
+            return take(queue, elements[0]);
+    }
+};
+
+
+// the back end is taken one by one
+struct Back_End {
+    template<class Queue, class T>
+    static void give(Queue& queue, T&& element) {
+        if constexpr (requires { queue.push_local(std::move(element)); })
+            queue.push_local(std::move(element));
+        else
+            queue.push(std::move(element));
+    }
+    template<class Queue, class T>
+    static bool take(Queue& queue, T& element) {
+        return queue.pull(element);
+    }
+    template<class Queue, class T>
+    static size_t take_bulk(Queue& queue, T* elements, size_t) {
+        return queue.pull(elements[0]);
+    }
+    template<class Queue, class T>
+    static size_t take_half(Queue& queue, T* elements, size_t) {
+        return queue.pull(elements[0]);
+    }
+};
+
+
+// An order writes the victims of a thief in the order to try them and
+// returns how many; cpus are those the workers are pinned to, if PINS.
+struct Random_Order {
+    static constexpr bool PINS = false;
+
+    Random_Order(unsigned, unsigned const*) {}
+
+    template<class Random>
+    unsigned victims(Random& random, unsigned index, unsigned size, unsigned* out) const {
+        unsigned first = random() % size;
+        unsigned n = 0;
+        for (unsigned i = 0; i < size; ++i)
+            if ((first + i) % size != index % size)
+                out[n++] = (first + i) % size;
+        return n;
+    }
+};
+
+
+struct Fixed_Order {
+    static constexpr bool PINS = false;
+
+    Fixed_Order(unsigned, unsigned const*) {}
+
+    template<class Random>
+    unsigned victims(Random&, unsigned index, unsigned size, unsigned* out) const {
+        unsigned n = 0;
+        for (unsigned i = 1; i < size; ++i)
+            out[n++] = (index + i) % size;
+        return n;
+    }
+};
+
+
+class Topology_Order {
+
+  private:
+    static constexpr unsigned TIER_SIZE = 4;
+
+    // of every thief, the others by tier
+    vector<vector<unsigned>> _tiers_[TIER_SIZE];
+
+    static unsigned tier(Cpu_Topology::Distance d) {
+        switch (d) {
+          case Cpu_Topology::SAME:
+          case Cpu_Topology::SIBLING:
+            return 0;
+          case Cpu_Topology::CACHE:
+            return 1;
+          case Cpu_Topology::NODE:
+            return 2;
+          default:
+            return 3;
+        }
+    }
+
+  public:
+    static constexpr bool PINS = true;
+
+    // without cpus, e.g. where affinity cannot be read, it is flat
+    Topology_Order(unsigned workersize, unsigned const* cpus,
+                   Cpu_Topology const& topology = Cpu_Topology::system()) {
+        for (vector<vector<unsigned>>& t : _tiers_)
+            t.resize(workersize);
+        for (unsigned i = 0; i < workersize; ++i)
+            for (unsigned j = 0; j < workersize; ++j)
+                if (j != i)
+                    _tiers_[cpus ? tier(topology.distance(cpus[i], cpus[j])) : 0][i].push_back(j);
+    }
+
+    template<class Random>
+    unsigned victims(Random& random, unsigned index, unsigned, unsigned* out) const {
+        unsigned n = 0;
+        for (vector<vector<unsigned>> const& t : _tiers_) {
+            vector<unsigned> const& others = t[index];
+            if (others.empty())
+                continue;
+            unsigned first = random() % others.size();
+            for (unsigned i = 0; i < others.size(); ++i)
+                out[n++] = others[(first + i) % others.size()];
+        }
+        return n;
+    }
+
+};
+
+
+struct Steal_One {
+    template<class Victim, class Queue, class T>
+    static size_t take(Queue& queue, T* elements, size_t) {
+        return Victim::take(queue, elements[0]);
+    }
+};
+
+
+struct Steal_Half {
+    template<class Victim, class Queue, class T>
+    static size_t take(Queue& queue, T* elements, size_t max) {
+        return Victim::take_half(queue, elements, max);
+    }
+};
+
+
+// the counts of a thief at some moment
+struct Steal_Stats {
+    size_t _attempts_ = 0;
+    size_t _successes_ = 0;
+    size_t _moved_ = 0;
+};
+
+
+struct No_Steal {
+    static constexpr bool STEALS = false;
+    static constexpr bool PINS = false;
+
+    No_Steal(unsigned, unsigned const*) {}
+
+    template<class Queue, class T>
+    size_t take(Queue& own, T* elements, size_t max) {
+        return Front_End::take_bulk(own, elements, max);
+    }
+
+    template<class Queue, class T>
+    bool steal(Queue*, unsigned, unsigned, T&) {
+        return false;
+    }
+
+    Steal_Stats stats(unsigned) const {
+        return Steal_Stats();
+    }
+};
+
+
+template<class Own = Front_End, class Victim = Front_End,
+         class Order = Random_Order, class Amount = Steal_Half>
+class Steal {
+
+  private:
+    static constexpr size_t STEAL_LIMIT = 32;
+
+    // counters written by its worker only, read by anyone
+    struct Thief {
+        std::minstd_rand _random_;
+        vector<unsigned> _victims_;
+        atomic<size_t> _attempts_{0};
+        atomic<size_t> _successes_{0};
+        atomic<size_t> _moved_{0};
+
+        static void add(atomic<size_t>& counter, size_t n) {
+            counter.store(counter.load(memory_order_relaxed) + n, memory_order_relaxed);
+        }
+    };
+
+    Order _order_;
+    Padded<Thief>* _thieves_;
+
+  public:
+    static constexpr bool STEALS = true;
+    static constexpr bool PINS = Order::PINS;
+
+    Steal(unsigned workersize, unsigned const* cpus)
+        : _order_(workersize, cpus), _thieves_(new Padded<Thief>[workersize]()) {
+        for (unsigned i = 0; i < workersize; ++i) {
+            _thieves_[i]._random_.seed(i + 1);
+            _thieves_[i]._victims_.resize(workersize);
+        }
+    }
+    ~Steal() {
+        delete[] _thieves_;
+    }
+
+    Steal(Steal const&) = delete;
+    Steal& operator=(Steal const&) = delete;
+
+    // by the owner only
+    template<class Queue, class T>
+    void give(Queue& own, T&& element) {
+        Own::give(own, std::move(element));
+    }
+
+    template<class Queue, class T>
+    size_t take(Queue& own, T* elements, size_t max) {
+        return Own::take_bulk(own, elements, max);
+    }
+
+    // every other queue, in Order; of the tasks taken all but the one
+    // returned go into the own queue
+    template<class Queue, class T>
+    bool steal(Queue* queues, unsigned size, unsigned index, T& element) {
+        Thief& thief = _thieves_[index];
+        unsigned own = index % size;
+        unsigned count = _order_.victims(thief._random_, index, size, thief._victims_.data());
+        T loot[STEAL_LIMIT];
+        for (unsigned i = 0; i < count; ++i) {
+            unsigned victim = thief._victims_[i];
+            Thief::add(thief._attempts_, 1);
+            if (size_t n = Amount::template take<Victim>(queues[victim], loot, STEAL_LIMIT)) {
+                element = std::move(loot[0]);
+                if (n > 1)
+                    queues[own].push_bulk(loot + 1, n - 1);
+                Thief::add(thief._successes_, 1);
+                Thief::add(thief._moved_, n);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Steal_Stats stats(unsigned index) const {
+        Steal_Stats s;
+        s._attempts_ = _thieves_[index]._attempts_.load(memory_order_relaxed);
+        s._successes_ = _thieves_[index]._successes_.load(memory_order_relaxed);
+        s._moved_ = _thieves_[index]._moved_.load(memory_order_relaxed);
+        return s;
+    }
+};
+
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * stop_test.cpp
+ *
+ * Testing that stopping a pool right after posting runs every task posted,
+ * in particular those a scheduler thread is moving into the worker queues
+ * at the time.
+ *
+ */
+
+#include <cstdio>
+
+#include <atomic>
+
+#include "blocking_overflow_blocking_unique_pool.h"
+#include "blocking_overflow_lockwise_mutual_pool.h"
+#include "blocking_shared_blocking_unique_pool.h"
+#include "blocking_shared_lockwise_mutual_pool.h"
+#include "blocking_unique_pool.h"
+#include "lockwise_mutual_pool.h"
+
+
+using std::atomic;
+
+
+template<class Pool>
+bool run(char const* name) {
+    unsigned const ROUNDS = 3000;
+    unsigned const TASKS = 600;
+    size_t lost = 0;
+    unsigned failed = 0;
+    for (unsigned i = 0; i < ROUNDS; ++i) {
+        atomic<unsigned> executed(0);
+        {
+            Pool_Config config;
+            config._workersize_ = 2;
+            Pool pool(config);
+            for (unsigned k = 0; k < TASKS; ++k)
+                pool.post([&executed] { executed.fetch_add(1, memory_order_relaxed); });
+        }
+        if (executed.load() != TASKS) {
+            lost += TASKS - executed.load();
+            ++failed;
+        }
+    }
+    std::fprintf(stderr, "[%s] %s: %u of %u rounds lost %zu tasks\n",
+                 failed ? "FAILED" : "ok", name, failed, ROUNDS, lost);
+    return !failed;
+}
+
+
+int main() {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    bool ok = run<Blocking_Shared_Blocking_Unique_Pool<>>("blocking_shared_blocking_unique");
+    ok = run<Blocking_Shared_Lockwise_Mutual_Pool<>>("blocking_shared_lockwise_mutual") && ok;
+    ok = run<Blocking_Overflow_Blocking_Unique_Pool<>>("blocking_overflow_blocking_unique") && ok;
+    ok = run<Blocking_Overflow_Lockwise_Mutual_Pool<>>("blocking_overflow_lockwise_mutual") && ok;
+    ok = run<Blocking_Unique_Pool<>>("blocking_unique") && ok;
+    ok = run<Lockwise_Mutual_Pool<>>("lockwise_mutual") && ok;
+
+    std::fprintf(stderr, "\nBye...\n");
+    return ok ? 0 : 1;
+}
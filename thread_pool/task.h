@@ -0,0 +1,405 @@
+/*
+ * task.h
+ *
+ * Tasks queued in Thread_Pool and the futures of their results.
+ *   - Task_Wrapper owns a type-erased callable and is movable only, it keeps
+ *     a callable inline if it fits and its move constructor does not throw,
+ *     and calls and moves it through a table of function pointers instead
+ *     of virtual functions; it also carries the time it was submitted at,
+ *     for latency.h, in what used to be padding
+ *   - make_relocatable() moves an inline callable which is not trivially
+ *     copyable to the heap, so that the bytes of the wrapper may be copied
+ *     as they are, which Lockfree_Deque does
+ *   - make_task() puts a callable, its result and the state shared with
+ *     its Future into one block, recycled through Block_Cache, instead of a
+ *     packaged_task shared state plus a separate Task_Wrapper allocation
+ *   - a Future waits by std::atomic::wait, and its task notifies only when
+ *     somebody does wait
+ *   - report_exception() is the default handler for tasks whose results
+ *     nobody waits for
+ *
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "block_cache.h"
+
+
+using std::atomic;
+using std::exception_ptr;
+using std::memory_order_acq_rel;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+
+
+class Task_Wrapper {
+
+  public:
+    static constexpr size_t INLINE_SIZE = 48;
+
+  private:
+    // a hand-rolled vtable
+    struct Ops {
+        void (*_invoke_)(void* storage);
+        void (*_destroy_)(void* storage);
+        void (*_move_)(void* from, void* to);   // and destroys from
+        Ops const* (*_box_)(void* storage);     // null if the bytes may be copied
+    };
+
+    // whatever keeps only a pointer in the storage
+    template<class P>
+    static void move_pointer(void* from, void* to) {
+        new (to) P*(*std::launder(static_cast<P**>(from)));
+    }
+
+    template<class F>
+    struct Heap {
+        static F*& get(void* storage) {
+            return *std::launder(static_cast<F**>(storage));
+        }
+        static void invoke(void* storage) {
+            (*get(storage))();
+        }
+        static void destroy(void* storage) {
+            delete get(storage);
+        }
+        static constexpr Ops OPS = { invoke, destroy, move_pointer<F>, nullptr };
+    };
+
+    template<class F>
+    struct Inline {
+        static F* get(void* storage) {
+            return std::launder(static_cast<F*>(storage));
+        }
+        static void invoke(void* storage) {
+            (*get(storage))();
+        }
+        static void destroy(void* storage) {
+            get(storage)->~F();
+        }
+        static void move(void* from, void* to) {
+            new (to) F(std::move(*get(from)));
+            get(from)->~F();
+        }
+        static Ops const* box(void* storage) {
+            F* f = new F(std::move(*get(storage)));
+            get(storage)->~F();
+            new (storage) F*(f);
+            return &Heap<F>::OPS;
+        }
+        static constexpr Ops OPS = { invoke, destroy, move,
+                                     std::is_trivially_copyable<F>::value ? nullptr : box };
+    };
+
+    // a task which manages its own life by call() and destroy()
+    template<class P>
+    struct Owned {
+        static P*& get(void* storage) {
+            return *std::launder(static_cast<P**>(storage));
+        }
+        static void invoke(void* storage) {
+            get(storage)->call();
+        }
+        static void destroy(void* storage) {
+            get(storage)->destroy();
+        }
+        static constexpr Ops OPS = { invoke, destroy, move_pointer<P>, nullptr };
+    };
+
+    // a callable which may throw while moved goes to the heap, so that
+    // moving a wrapper never throws
+    template<class F>
+    static constexpr bool fits_inline() {
+        return sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<F>::value;
+    }
+
+    alignas(std::max_align_t) unsigned char _storage_[INLINE_SIZE];
+    Ops const* _ops_;
+    uint64_t _stamp_;       // 0 if never stamped
+
+    void reset() {
+        if (_ops_) {
+            _ops_->_destroy_(_storage_);
+            _ops_ = nullptr;
+        }
+    }
+
+  public:
+    Task_Wrapper() : _ops_(nullptr), _stamp_(0) {}
+    // support move
+    Task_Wrapper(Task_Wrapper&& other) noexcept : _ops_(other._ops_), _stamp_(other._stamp_) {
+        if (_ops_) {
+            _ops_->_move_(other._storage_, _storage_);
+            other._ops_ = nullptr;
+        }
+    }
+    Task_Wrapper& operator=(Task_Wrapper&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other._ops_) {
+                other._ops_->_move_(other._storage_, _storage_);
+                _ops_ = other._ops_;
+                other._ops_ = nullptr;
+            }
+            _stamp_ = other._stamp_;
+        }
+        return *this;
+    }
+    // no copy
+    Task_Wrapper(Task_Wrapper&) = delete;
+    Task_Wrapper& operator=(Task_Wrapper&) = delete;
+    ~Task_Wrapper() {
+        reset();
+    }
+    template<class T, class F = typename std::decay<T>::type,
+             class = typename std::enable_if<!std::is_same<F, Task_Wrapper>::value>::type>
+    Task_Wrapper(T&& t) : _stamp_(0) {
+        if constexpr (fits_inline<F>()) {
+            new (_storage_) F(std::forward<T>(t));
+            _ops_ = &Inline<F>::OPS;
+        } else {
+            new (_storage_) F*(new F(std::forward<T>(t)));
+            _ops_ = &Heap<F>::OPS;
+        }
+    }
+
+    template<class P>
+    static Task_Wrapper adopt(P* p) {
+        Task_Wrapper w;
+        new (w._storage_) P*(p);
+        w._ops_ = &Owned<P>::OPS;
+        return w;
+    }
+
+    void operator()() {
+        _ops_->_invoke_(_storage_);
+    }
+
+    // whether the bytes of this wrapper may be copied as they are
+    bool relocatable() const {
+        return !_ops_ || !_ops_->_box_;
+    }
+    void make_relocatable() {
+        if (!relocatable())
+            _ops_ = _ops_->_box_(_storage_);
+    }
+
+    void stamp(uint64_t ns) {
+        _stamp_ = ns;
+    }
+    uint64_t stamp() const {
+        return _stamp_;
+    }
+
+};
+
+
+// the result of a task, or nothing for void
+template<class R>
+struct Task_Value {
+    alignas(R) unsigned char _buf_[sizeof(R)];
+    bool _has_ = false;
+
+    template<class F>
+    void run(F& f) {
+        new (_buf_) R(f());
+        _has_ = true;
+    }
+    R take() {
+        return std::move(*std::launder(reinterpret_cast<R*>(_buf_)));
+    }
+    ~Task_Value() {
+        if (_has_) std::launder(reinterpret_cast<R*>(_buf_))->~R();
+    }
+};
+
+template<>
+struct Task_Value<void> {
+    template<class F>
+    void run(F& f) {
+        f();
+    }
+    void take() {}
+};
+
+
+// the part of a task its Future sees
+template<class R>
+class Task_State {
+
+  protected:
+    static constexpr unsigned READY = 1;
+    static constexpr unsigned WAITING = 2;
+
+    atomic<unsigned> _status_;
+    atomic<unsigned> _refs_;       // the Task_Wrapper and the Future
+    Task_Value<R> _value_;
+    exception_ptr _error_;
+    void (*_delete_)(Task_State*);  // deletes the whole task
+
+    void set_ready() {
+        if (_status_.exchange(READY, memory_order_acq_rel) & WAITING)
+            _status_.notify_all();
+    }
+
+  public:
+    explicit Task_State(void (*d)(Task_State*)) : _status_(0), _refs_(2), _delete_(d) {}
+
+    bool ready() const {
+        return _status_.load(memory_order_acquire) & READY;
+    }
+
+    void wait() {
+        unsigned s = _status_.load(memory_order_acquire);
+        while (!(s & READY)) {
+            if (!(s & WAITING)) {
+                if (!_status_.compare_exchange_weak(s, s | WAITING, memory_order_acquire))
+                    continue;
+                s |= WAITING;
+            }
+            _status_.wait(s, memory_order_acquire);
+            s = _status_.load(memory_order_acquire);
+        }
+    }
+
+    R get() {
+        wait();
+        if (_error_)
+            std::rethrow_exception(_error_);
+        return _value_.take();
+    }
+
+    void release() {
+        if (_refs_.fetch_sub(1, memory_order_acq_rel) == 1)
+            _delete_(this);
+    }
+
+    // the Task_Wrapper lets it go
+    void destroy() {
+        // never called, e.g. a pool destructed with tasks left in it
+        if (!(_status_.load(memory_order_relaxed) & READY)) {
+            _error_ = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            set_ready();
+        }
+        release();
+    }
+
+};
+
+
+template<class R, class F>
+class Packaged_Task : public Task_State<R> {
+
+  private:
+    F _f_;
+
+    static void remove(Task_State<R>* t) {
+        delete static_cast<Packaged_Task*>(t);
+    }
+
+  public:
+    explicit Packaged_Task(F&& f) : Task_State<R>(remove), _f_(std::move(f)) {}
+
+    void call() {
+        try {
+            this->_value_.run(_f_);
+        } catch (...) {
+            this->_error_ = std::current_exception();
+        }
+        this->set_ready();
+    }
+
+    static void* operator new(size_t) {
+        return Block_Cache<block_size(sizeof(Packaged_Task))>::allocate();
+    }
+    static void operator delete(void* p) {
+        Block_Cache<block_size(sizeof(Packaged_Task))>::deallocate(p);
+    }
+
+};
+
+
+template<class R>
+class Future {
+
+  private:
+    Task_State<R>* _state_;
+
+  public:
+    Future() : _state_(nullptr) {}
+    explicit Future(Task_State<R>* state) : _state_(state) {}
+    // support move
+    Future(Future&& other) : _state_(other._state_) {
+        other._state_ = nullptr;
+    }
+    Future& operator=(Future&& other) {
+        if (_state_) _state_->release();
+        _state_ = other._state_;
+        other._state_ = nullptr;
+        return *this;
+    }
+    // no copy
+    Future(Future&) = delete;
+    Future& operator=(Future&) = delete;
+    ~Future() {
+        if (_state_) _state_->release();
+    }
+
+    bool valid() const {
+        return _state_ != nullptr;
+    }
+
+    bool ready() const {
+        return _state_->ready();
+    }
+
+    void wait() const {
+        _state_->wait();
+    }
+
+    // like std::future, a Future is no longer valid after get()
+    R get() {
+        Future f(std::move(*this));
+        return f._state_->get();
+    }
+
+};
+
+
+// the default handler of exceptions from tasks run by Thread_Pool::execute()
+inline void report_exception(exception_ptr e) {
+    try {
+        std::rethrow_exception(e);
+    } catch (std::exception const& x) {
+        std::fprintf(stderr, "Task failed: %s\n", x.what());
+    } catch (...) {
+        std::fprintf(stderr, "Task failed.\n");
+    }
+}
+
+
+template<class Callable>
+Future<typename std::result_of<Callable()>::type> make_task(Callable&& c, Task_Wrapper& task) {
+    typedef typename std::result_of<Callable()>::type R;
+    typedef typename std::decay<Callable>::type F;
+    Packaged_Task<R, F>* t = new Packaged_Task<R, F>(F(std::forward<Callable>(c)));
+    task = Task_Wrapper::adopt(t);
+    return Future<R>(t);
+}
+
+
+#endif
@@ -0,0 +1,14 @@
+#!/bin/bash
+#
+# Builds benchmark_test.cpp and runs its matrix, writing the results into the
+# file given first and passing the rest to the benchmark, e.g.
+#   ./test.sh results.csv --variants lockwise_shared,lockwise_mutual --producers 1,10
+#   ./test.sh results.json --format json --delays 0,1000,8000
+#   ./test.sh pinning.csv --affinities none,mask,cores,spread --workers 4,8
+#   ./test.sh front.csv --producers 10,20,40 --affinities none --variants blocking_shared_blocking_unique,blocking_overflow_blocking_unique,blocking_shared_lockwise_mutual,blocking_overflow_lockwise_mutual
+#   ./test.sh curve.csv --kernels spin:5000 --rates 50000,100000,200000,400000
+#   ./test.sh idle.csv --idles own,park,adaptive --affinities none --rates 10000,100000,400000
+#
+
+g++ -std=c++20 -O2 -pthread -o benchmark benchmark_test.cpp || exit 1
+./benchmark --output "$1" "${@:2}" 1>/dev/null
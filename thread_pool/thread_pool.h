@@ -0,0 +1,583 @@
+/*
+ * thread_pool.h
+ *
+ * A thread pool accepting callables as tasks, put together from policies:
+ *   - QueuePolicy: Shared_Queue<Queue>, one queue for all workers, or
+ *     Worker_Queues<Queue>, a queue within each worker thread
+ *   - PlacementPolicy: which queue a task is submitted into, see placement.h
+ *   - StealPolicy: whether workers take tasks from the queues of the others,
+ *     see stealing.h
+ *   - IdlePolicy: what a worker does when it finds no task, see idle.h;
+ *     With_Idle<Pool, Idle>::Type is a variant with another one
+ *   - FrontEnd: Direct_Front, tasks go straight into the queues,
+ *     Scheduled_Front, tasks go into a pool queue first and a scheduler
+ *     thread assigns them to the queues in batches, or Overflow_Front,
+ *     submitters put tasks straight into a queue holding less than
+ *     OVERFLOW_LIMIT tasks and into the pool queue otherwise, so that the
+ *     scheduler thread only deals with the overflow
+ *
+ * A task submitted from a worker of a stealing pool skips the front end and
+ * placement and goes into the queue of that worker, see stealing.h.  Pools
+ * not stealing do not, as a task waiting for a child there would wait for
+ * ever.
+ *
+ * Given Pool_Config::_affinity_, or a StealPolicy ordering victims by
+ * topology, every worker pins itself to a CPU when it starts, round the
+ * CPUs of the affinity, see topology.h.
+ *
+ * Given Pool_Config::_latency_, tasks are stamped when submitted and every
+ * worker records their latencies on its own, see latency.h.
+ *
+ * Every published variant is an alias of Thread_Pool in a header of its own,
+ * so variants may be compared within one program.
+ *
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "blocking_queue.h"
+#include "cache_line.h"
+#include "idle.h"
+#include "latency.h"
+#include "lockwise_queue.h"
+#include "placement.h"
+#include "pool_config.h"
+#include "stealing.h"
+#include "task.h"
+#include "topology.h"
+
+
+using std::atomic;
+using std::exception_ptr;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::thread;
+using std::vector;
+
+
+template<class Queue>
+struct Shared_Queue {
+    typedef Queue Queue_Type;
+    static unsigned size(unsigned) {
+        return 1;
+    }
+};
+
+
+template<class Queue>
+struct Worker_Queues {
+    typedef Queue Queue_Type;
+    static unsigned size(unsigned workersize) {
+        return workersize;
+    }
+};
+
+
+struct Direct_Front {
+
+    template<class Sink>
+    class Front {
+
+      private:
+        Sink& _sink_;
+
+      public:
+        explicit Front(Sink& sink) : _sink_(sink) {}
+
+        void start() {}
+        void stop() {}
+
+        void push(Task_Wrapper&& task) {
+            _sink_.dispatch(std::move(task));
+        }
+        void push_bulk(Task_Wrapper* tasks, size_t n) {
+            _sink_.dispatch_bulk(tasks, n);
+        }
+
+        bool empty() const {
+            return true;
+        }
+        size_t size() const {
+            return 0;
+        }
+
+    };
+
+};
+
+
+// QueueLimit is how many tasks a queue holds at most for a submitter to
+// skip the pool queue, 0 for never
+template<size_t QueueLimit>
+struct Pool_Queue_Front {
+
+    template<class Sink>
+    class Front {
+
+      private:
+        static constexpr unsigned BATCH_LIMIT = 32;
+
+        Sink& _sink_;
+        Padded<Blocking_Queue<Task_Wrapper>> _poolqueue_;
+        thread _scheduler_;
+
+        // a batch from the pool queue goes to the worker queues in chunks,
+        // until the pool queue is closed
+        void schedule() {
+            Task_Wrapper batch[BATCH_LIMIT];
+            while (size_t n = _poolqueue_.pop_bulk(batch, BATCH_LIMIT))
+                _sink_.dispatch_bulk(batch, n);
+        }
+
+      public:
+        explicit Front(Sink& sink) : _sink_(sink) {}
+
+        void start() {
+            _scheduler_ = thread(&Front::schedule, this);
+        }
+        // drains the pool queue into the sink, before the sink stops
+        void stop() {
+            _poolqueue_.close();
+            if (_scheduler_.joinable())
+                _scheduler_.join();
+        }
+
+        void push(Task_Wrapper&& task) {
+            if constexpr (QueueLimit > 0)
+                if (_sink_.try_dispatch(&task, 1, QueueLimit))
+                    return;
+            _poolqueue_.push(std::move(task));
+        }
+        void push_bulk(Task_Wrapper* tasks, size_t n) {
+            if constexpr (QueueLimit > 0)
+                if (_sink_.try_dispatch(tasks, n, QueueLimit))
+                    return;
+            _poolqueue_.push_bulk(tasks, n);
+        }
+
+        bool empty() const {
+            return _poolqueue_.empty();
+        }
+        size_t size() const {
+            return _poolqueue_.size();
+        }
+
+    };
+
+};
+
+
+typedef Pool_Queue_Front<0> Scheduled_Front;
+
+constexpr size_t OVERFLOW_LIMIT = 64;
+
+typedef Pool_Queue_Front<OVERFLOW_LIMIT> Overflow_Front;
+
+
+template<class QueuePolicy = Worker_Queues<Lockwise_Queue<Task_Wrapper>>,
+         class PlacementPolicy = Random_Placement,
+         class StealPolicy = Steal<>,
+         class IdlePolicy = Park_Idle,
+         class FrontEnd = Direct_Front>
+class Thread_Pool {
+
+    static_assert(!(IdlePolicy::BLOCKS && StealPolicy::STEALS),
+                  "a worker blocked in its own queue cannot steal");
+
+    typedef typename QueuePolicy::Queue_Type Queue;
+    typedef typename FrontEnd::template Front<Thread_Pool> Front;
+    friend Front;
+
+  private:
+    static constexpr unsigned BATCH_LIMIT = 32;
+
+    // polled by every worker after every task, the pool starts a cache line
+    alignas(CACHE_LINE_SIZE) atomic<bool> _suspend_;
+    atomic<bool> _done_;
+    unsigned _workersize_;
+    unsigned _queuesize_;
+    unsigned _batchsize_;
+    vector<unsigned> _cpus_;
+    thread* _workers_;
+    Padded<Queue>* _queues_;
+    PlacementPolicy _placement_;
+    StealPolicy _steal_;
+    IdlePolicy _idle_;
+    Front _front_;
+    Task_Latency* _latency_;
+    Padded<Task_Latency>* _latencies_;
+    std::function<void(exception_ptr)> _handler_ = report_exception;
+
+    // the pool a worker thread belongs to, and its index
+    inline static thread_local Thread_Pool* _localpool_ = nullptr;
+    inline static thread_local unsigned _localindex_ = 0;
+
+    static Affinity affinity(Pool_Config const& config) {
+        Affinity affinity = config._affinity_;
+        if (StealPolicy::PINS && affinity._mode_ == Affinity::NONE)
+            affinity._mode_ = Affinity::MASK;
+        return affinity;
+    }
+
+    static unsigned workersize(Pool_Config const& config) {
+        if (config._workersize_)
+            return config._workersize_;
+        if (size_t n = affinity_cpus(affinity(config)).size())
+            return n;
+        return std::max(thread::hardware_concurrency(), 1u);
+    }
+
+    static unsigned batchsize(Pool_Config const& config, unsigned queuesize) {
+        // nobody else pops a worker queue
+        if (!StealPolicy::STEALS && queuesize > 1)
+            return BATCH_LIMIT;
+        // a blocked worker might swallow the wake-ups of the others
+        if (IdlePolicy::BLOCKS)
+            return 1;
+        return std::min(std::max(config._batchsize_, 1u), BATCH_LIMIT);
+    }
+
+    // empty for workers left to the OS scheduler
+    static vector<unsigned> cpus(Pool_Config const& config, unsigned workersize) {
+        vector<unsigned> cpus;
+        vector<unsigned> affine = affinity_cpus(affinity(config));
+        for (unsigned i = 0; !affine.empty() && i < workersize; ++i)
+            cpus.push_back(affine[i % affine.size()]);
+        return cpus;
+    }
+
+    // the workers parking together
+    unsigned group(unsigned queue) const {
+        return StealPolicy::STEALS ? 0 : queue;
+    }
+
+    unsigned place() {
+        return _queuesize_ == 1 ? 0 : _placement_(_queues_, _queuesize_);
+    }
+
+    bool done() const {
+        return _done_.load(memory_order_acquire);
+    }
+
+    bool starving(unsigned index) const {
+        if (done())
+            return false;
+        if (!StealPolicy::STEALS)
+            return _queues_[index % _queuesize_].empty();
+        for (unsigned i = 0; i < _queuesize_; ++i)
+            if (!_queues_[i].empty())
+                return false;
+        return true;
+    }
+
+    size_t take(unsigned index, Task_Wrapper* batch) {
+        if (size_t n = _steal_.take(_queues_[index % _queuesize_], batch, _batchsize_))
+            return n;
+        return _steal_.steal(_queues_, _queuesize_, index, batch[0]) ? 1 : 0;
+    }
+
+    void stamp(Task_Wrapper* tasks, size_t n) {
+        if (!_latency_)
+            return;
+        uint64_t now = latency_clock();
+        for (size_t i = 0; i < n; ++i)
+            tasks[i].stamp(now);
+    }
+
+    // unstamped tasks are not recorded
+    void run(unsigned index, Task_Wrapper* batch, size_t n) {
+        if (!_latencies_) {
+            for (size_t i = 0; i < n; ++i)
+                Task_Wrapper(std::move(batch[i]))();
+            return;
+        }
+        Task_Latency& latency = _latencies_[index];
+        uint64_t dequeued = latency_clock();
+        uint64_t start = dequeued;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t stamp = batch[i].stamp();
+            Task_Wrapper(std::move(batch[i]))();
+            uint64_t end = latency_clock();
+            if (stamp) {
+                latency._queueing_.record(dequeued - stamp);
+                latency._execution_.record(end - start);
+                latency._endtoend_.record(end - stamp);
+            }
+            start = end;
+        }
+    }
+
+    void work(unsigned index) {
+        _localpool_ = this;
+        _localindex_ = index;
+        if (!_cpus_.empty())
+            pin_this_thread(_cpus_[index]);
+        Task_Wrapper batch[BATCH_LIMIT];
+        if constexpr (IdlePolicy::BLOCKS) {
+            while (!done()) {
+                size_t n = _queues_[index % _queuesize_].pop_bulk(batch, _batchsize_);
+                run(index, batch, n);
+                while (_suspend_.load(memory_order_acquire))
+                    std::this_thread::yield();
+            }
+        } else {
+            typename IdlePolicy::Waiter waiter(_idle_, group(index % _queuesize_));
+            while (!done()) {
+                if (size_t n = take(index, batch)) {
+                    run(index, batch, n);
+                    waiter.busy();
+                } else {
+                    waiter.idle([this, index] { return starving(index); });
+                }
+                while (_suspend_.load(memory_order_acquire))
+                    std::this_thread::yield();
+            }
+            // what a thief moved into its queue while the pool was stopping
+            while (size_t n = _steal_.take(_queues_[index % _queuesize_], batch, _batchsize_))
+                run(index, batch, n);
+        }
+    }
+
+    void stop() {
+        size_t remaining = 0;
+        _suspend_.store(true, memory_order_release);
+        remaining = _front_.size();
+        for (unsigned i = 0; _queues_ && i < _queuesize_; ++i)
+            remaining += _queues_[i].size();
+        _suspend_.store(false, memory_order_release);
+        // the front first, so that no batch reaches the queues after them
+        _front_.stop();
+        for (unsigned i = 0; _queues_ && i < _queuesize_; ++i)
+            while (!_queues_[i].empty())
+                std::this_thread::yield();
+        std::fprintf(stderr, "\n%zu tasks remain before destructing pool.\n", remaining);
+        _done_.store(true, memory_order_release);
+        _idle_.notify_all();
+        if constexpr (IdlePolicy::BLOCKS) {
+            for (unsigned i = 0; _queues_ && i < _queuesize_; ++i)
+                _queues_[i].close();
+        }
+        for (unsigned i = 0; _workers_ && i < _workersize_; ++i)
+            if (_workers_[i].joinable())
+                _workers_[i].join();
+        for (unsigned i = 0; _latencies_ && i < _workersize_; ++i)
+            _latency_->merge(_latencies_[i]);
+        delete[] _workers_;
+        delete[] _queues_;
+        delete[] _latencies_;
+    }
+
+    void push(Task_Wrapper&& task) {
+        if constexpr (StealPolicy::STEALS) {
+            if (_localpool_ == this) {
+                unsigned q = _localindex_ % _queuesize_;
+                _steal_.give(_queues_[q], std::move(task));
+                _idle_.notify(group(q), 1);
+                return;
+            }
+        }
+        _front_.push(std::move(task));
+    }
+
+    void push_bulk(Task_Wrapper* tasks, size_t n) {
+        if constexpr (StealPolicy::STEALS) {
+            if (_localpool_ == this) {
+                for (size_t i = 0; i < n; ++i)
+                    push(std::move(tasks[i]));
+                return;
+            }
+        }
+        _front_.push_bulk(tasks, n);
+    }
+
+    void dispatch(Task_Wrapper&& task) {
+        unsigned q = place();
+        _queues_[q].push(std::move(task));
+        _idle_.notify(group(q), 1);
+    }
+
+    // n tasks into queue q, waking its workers; a bounded queue takes what
+    // it has room for at a time, and its workers are woken to drain it
+    // before the rest, or parked workers would never make room
+    void fill(unsigned q, Task_Wrapper* tasks, size_t n) {
+        if constexpr (requires { _queues_[q].try_push_bulk(tasks, n); }) {
+            for (size_t k = 0; ; std::this_thread::yield()) {
+                size_t m = _queues_[q].try_push_bulk(tasks + k, n - k);
+                if (m)
+                    _idle_.notify(group(q), m < _workersize_ ? m : _workersize_);
+                k += m;
+                if (k == n)
+                    return;
+            }
+        } else {
+            if (n == 1)
+                _queues_[q].push(std::move(tasks[0]));
+            else
+                _queues_[q].push_bulk(tasks, n);
+            _idle_.notify(group(q), n < _workersize_ ? n : _workersize_);
+        }
+    }
+
+    // all into the queue placed unless it holds limit tasks already, the
+    // count being a hint only
+    bool try_dispatch(Task_Wrapper* tasks, size_t n, size_t limit) {
+        unsigned q = place();
+        if (_queues_[q].size() >= limit)
+            return false;
+        fill(q, tasks, n);
+        return true;
+    }
+
+    // no more than one chunk for each queue
+    void dispatch_bulk(Task_Wrapper* tasks, size_t n) {
+        size_t chunk = (n + _queuesize_ - 1) / _queuesize_;
+        unsigned q = place();
+        for (size_t k = 0; k < n; k += chunk, q = (q + 1) % _queuesize_)
+            fill(q, tasks + k, std::min(chunk, n - k));
+    }
+
+  public:
+    explicit Thread_Pool(Pool_Config config = Pool_Config(), PlacementPolicy placement = PlacementPolicy())
+        : _suspend_(false), _done_(false),
+          _workersize_(workersize(config)),
+          _queuesize_(QueuePolicy::size(_workersize_)),
+          _batchsize_(batchsize(config, _queuesize_)),
+          _cpus_(cpus(config, _workersize_)),
+          _workers_(nullptr), _queues_(nullptr),
+          _placement_(placement),
+          _steal_(_workersize_, _cpus_.empty() ? nullptr : _cpus_.data()),
+          _idle_(StealPolicy::STEALS ? 1 : _queuesize_, config),
+          _front_(*this),
+          _latency_(config._latency_), _latencies_(nullptr) {
+        try {
+            _workers_ = new thread[_workersize_]();
+            _queues_ = new Padded<Queue>[_queuesize_]();
+            if (_latency_)
+                _latencies_ = new Padded<Task_Latency>[_workersize_]();
+            for (unsigned i = 0; i < _workersize_; ++i)
+                _workers_[i] = thread(&Thread_Pool::work, this, i);
+            _front_.start();
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+    ~Thread_Pool() {
+        stop();
+    }
+
+    Thread_Pool(Thread_Pool const&) = delete;
+    Thread_Pool& operator=(Thread_Pool const&) = delete;
+
+    unsigned workersize() const {
+        return _workersize_;
+    }
+
+    // the CPU of every worker, empty for a pool not pinning them
+    vector<unsigned> const& cpus() const {
+        return _cpus_;
+    }
+
+    // all zero for a pool not stealing
+    Steal_Stats steal_stats(unsigned worker) const {
+        return _steal_.stats(worker);
+    }
+
+    template<class Callable>
+    Future<typename std::result_of<Callable()>::type> submit(Callable c) {
+        typedef typename std::result_of<Callable()>::type R;
+        Task_Wrapper task;
+        Future<R> r = make_task(std::move(c), task);
+        stamp(&task, 1);
+        push(std::move(task));
+        return r;
+    }
+
+    // no Future, an exception from the task terminates the program
+    template<class Callable>
+    void post(Callable c) {
+        Task_Wrapper task(std::move(c));
+        stamp(&task, 1);
+        push(std::move(task));
+    }
+
+    // like post(), for an open-loop generator: intended is when the task was
+    // due, on latency_clock(), and its latencies count from then
+    template<class Callable>
+    void post_at(uint64_t intended, Callable c) {
+        Task_Wrapper task(std::move(c));
+        task.stamp(intended);
+        push(std::move(task));
+    }
+
+    // first and last are forward iterators to callables
+    template<class Iterator>
+    vector<Future<typename std::result_of<typename std::iterator_traits<Iterator>::value_type()>::type>>
+    submit_bulk(Iterator first, Iterator last) {
+        typedef typename std::iterator_traits<Iterator>::value_type Callable;
+        typedef typename std::result_of<Callable()>::type R;
+        size_t n = std::distance(first, last);
+        vector<Task_Wrapper> tasks(n);
+        vector<Future<R>> rs;
+        rs.reserve(n);
+        for (size_t i = 0; i < n; ++i, ++first)
+            rs.push_back(make_task(Callable(*first), tasks[i]));
+        stamp(tasks.data(), n);
+        push_bulk(tasks.data(), n);
+        return rs;
+    }
+
+    template<class Iterator>
+    void post_bulk(Iterator first, Iterator last) {
+        vector<Task_Wrapper> tasks;
+        tasks.reserve(std::distance(first, last));
+        for (; first != last; ++first)
+            tasks.emplace_back(*first);
+        stamp(tasks.data(), tasks.size());
+        push_bulk(tasks.data(), tasks.size());
+    }
+
+    // like post(), but an exception from the task goes to the handler
+    template<class Callable>
+    void execute(Callable c) {
+        post([this, c = std::move(c)]() mutable {
+            try {
+                c();
+            } catch (...) {
+                _handler_(std::current_exception());
+            }
+        });
+    }
+
+    // not to be called while tasks are running
+    void set_exception_handler(std::function<void(exception_ptr)> handler) {
+        _handler_ = std::move(handler);
+    }
+
+};
+
+
+template<class Pool, class Idle>
+struct With_Idle;
+
+
+template<class QueuePolicy, class PlacementPolicy, class StealPolicy, class IdlePolicy, class FrontEnd, class Idle>
+struct With_Idle<Thread_Pool<QueuePolicy, PlacementPolicy, StealPolicy, IdlePolicy, FrontEnd>, Idle> {
+    typedef Thread_Pool<QueuePolicy, PlacementPolicy, StealPolicy, Idle, FrontEnd> Type;
+};
+
+
+#endif
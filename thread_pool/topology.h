@@ -0,0 +1,264 @@
+/*
+ * topology.h
+ *
+ * The CPU layout of a Linux machine as sysfs tells it, for pinning workers
+ * and for stealing from the nearest ones first.
+ *   - Cpu_Topology reads, for every online CPU, its core and package from
+ *     cpuN/topology, its L3 from the shared_cpu_list of the level 3 entry
+ *     of cpuN/cache, and its NUMA node from the cpuN/nodeM link; what
+ *     cannot be read is taken as shared by all, i.e. a flat machine
+ *   - distance() ranks two CPUs: the same, SMT siblings, sharing an L3, on
+ *     one NUMA node, or remote
+ *   - allowed_cpus() is what the process affinity mask lets it run on
+ *   - pin_this_thread() binds the calling thread to a CPU by
+ *     pthread_setaffinity_np
+ *   - Affinity tells how the workers of a pool are pinned, and
+ *     affinity_cpus() the CPUs they are pinned to in turn; every mode keeps
+ *     within the process affinity mask
+ *       - none      left to the OS scheduler
+ *       - mask      round the CPUs of the mask
+ *       - cores     one CPU of every physical core
+ *       - spread    round the mask, skipping the SMT siblings of CPUs taken
+ *                   until every core has one
+ *       - cpus:L    round the CPU list L, like "0-3" or "8"
+ *
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+using std::string;
+using std::vector;
+
+
+// "0-3,8,10-11" to {0, 1, 2, 3, 8, 10, 11}
+inline vector<unsigned> parse_cpu_list(char const* list) {
+    vector<unsigned> cpus;
+    for (char const* p = list; *p && *p != '\n'; ) {
+        char* end;
+        unsigned first = std::strtoul(p, &end, 10);
+        if (end == p)
+            break;
+        unsigned last = first;
+        if (*end == '-')
+            last = std::strtoul(end + 1, &end, 10);
+        for (unsigned cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return cpus;
+}
+
+
+// the first line of a file, empty if it cannot be read
+inline string read_line(string const& path) {
+    char buf[4096] = {};
+    FILE* in = std::fopen(path.c_str(), "r");
+    if (!in)
+        return string();
+    if (!std::fgets(buf, sizeof(buf), in))
+        buf[0] = '\0';
+    std::fclose(in);
+    return buf;
+}
+
+
+inline vector<unsigned> allowed_cpus() {
+    vector<unsigned> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+    return cpus;
+}
+
+
+inline bool pin_this_thread(unsigned cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+
+class Cpu_Topology {
+
+  public:
+    enum Distance { SAME, SIBLING, CACHE, NODE, REMOTE };
+
+    struct Cpu {
+        unsigned _cpu_;
+        int _package_;
+        int _core_;
+        int _l3_;           // the first CPU sharing it
+        int _node_;
+    };
+
+  private:
+    vector<Cpu> _cpus_;
+
+    static int read_int(string const& path) {
+        string line = read_line(path);
+        return line.empty() ? -1 : std::atoi(line.c_str());
+    }
+
+    static int read_l3(string const& cpudir) {
+        for (unsigned i = 0; ; ++i) {
+            string index = cpudir + "/cache/index" + std::to_string(i);
+            int level = read_int(index + "/level");
+            if (level < 0)
+                return -1;
+            if (level == 3) {
+                vector<unsigned> shared = parse_cpu_list(read_line(index + "/shared_cpu_list").c_str());
+                return shared.empty() ? -1 : static_cast<int>(shared[0]);
+            }
+        }
+    }
+
+    static int read_node(string const& cpudir) {
+        int node = -1;
+        if (DIR* dir = opendir(cpudir.c_str())) {
+            while (dirent* e = readdir(dir))
+                if (!std::strncmp(e->d_name, "node", 4) && e->d_name[4] >= '0' && e->d_name[4] <= '9')
+                    node = std::atoi(e->d_name + 4);
+            closedir(dir);
+        }
+        return node;
+    }
+
+  public:
+    // root is where sysfs keeps the CPUs
+    explicit Cpu_Topology(string const& root = "/sys/devices/system/cpu") {
+        for (unsigned cpu : parse_cpu_list(read_line(root + "/online").c_str())) {
+            string dir = root + "/cpu" + std::to_string(cpu);
+            _cpus_.push_back({cpu,
+                              read_int(dir + "/topology/physical_package_id"),
+                              read_int(dir + "/topology/core_id"),
+                              read_l3(dir),
+                              read_node(dir)});
+        }
+    }
+
+    // the machine's own, read once
+    static Cpu_Topology const& system() {
+        static Cpu_Topology const TOPOLOGY;
+        return TOPOLOGY;
+    }
+
+    vector<Cpu> const& cpus() const {
+        return _cpus_;
+    }
+
+    // null for a CPU not online
+    Cpu const* find(unsigned cpu) const {
+        for (Cpu const& c : _cpus_)
+            if (c._cpu_ == cpu)
+                return &c;
+        return nullptr;
+    }
+
+    Distance distance(unsigned a, unsigned b) const {
+        if (a == b)
+            return SAME;
+        Cpu const* x = find(a);
+        Cpu const* y = find(b);
+        if (!x || !y)
+            return CACHE;
+        if (x->_core_ >= 0 && x->_core_ == y->_core_ && x->_package_ == y->_package_)
+            return SIBLING;
+        if (x->_l3_ == y->_l3_)
+            return CACHE;
+        if (x->_node_ == y->_node_)
+            return NODE;
+        return REMOTE;
+    }
+
+};
+
+
+struct Affinity {
+    enum Mode { NONE, MASK, CORES, SPREAD, EXPLICIT };
+
+    Mode _mode_ = NONE;
+    vector<unsigned> _cpus_;        // of EXPLICIT
+};
+
+
+struct Affinity_Mode {
+    char const* _name_;
+    Affinity::Mode _mode_;
+};
+
+
+Affinity_Mode const AFFINITY_MODES[] = {
+    {"none", Affinity::NONE},
+    {"mask", Affinity::MASK},
+    {"cores", Affinity::CORES},
+    {"spread", Affinity::SPREAD},
+};
+
+
+// a name of AFFINITY_MODES or "cpus:L", false for anything else
+inline bool parse_affinity(char const* spec, Affinity& affinity) {
+    if (!std::strncmp(spec, "cpus:", 5)) {
+        affinity._mode_ = Affinity::EXPLICIT;
+        affinity._cpus_ = parse_cpu_list(spec + 5);
+        return !affinity._cpus_.empty();
+    }
+    for (Affinity_Mode const& m : AFFINITY_MODES) {
+        if (!std::strcmp(spec, m._name_)) {
+            affinity._mode_ = m._mode_;
+            affinity._cpus_.clear();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// empty for NONE, or if no CPU is left
+inline vector<unsigned> affinity_cpus(Affinity const& affinity,
+                                      Cpu_Topology const& topology = Cpu_Topology::system()) {
+    vector<unsigned> cpus;
+    if (affinity._mode_ == Affinity::NONE)
+        return cpus;
+    vector<unsigned> allowed = allowed_cpus();
+    if (affinity._mode_ == Affinity::MASK)
+        return allowed;
+    if (affinity._mode_ == Affinity::EXPLICIT) {
+        for (unsigned cpu : affinity._cpus_)
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end())
+                cpus.push_back(cpu);
+        return cpus;
+    }
+    // the first CPU met of every core, then the siblings
+    vector<unsigned> siblings;
+    for (unsigned cpu : allowed) {
+        bool taken = false;
+        for (unsigned c : cpus)
+            taken = taken || topology.distance(c, cpu) == Cpu_Topology::SIBLING;
+        (taken ? siblings : cpus).push_back(cpu);
+    }
+    if (affinity._mode_ == Affinity::SPREAD)
+        cpus.insert(cpus.end(), siblings.begin(), siblings.end());
+    return cpus;
+}
+
+
+#endif
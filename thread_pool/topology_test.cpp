@@ -0,0 +1,62 @@
+/*
+ * topology_test.cpp
+ *
+ * Printing the CPU topology as read from sysfs, or from a copy of its cpu
+ * directory given as the argument, and the order a worker pinned to each
+ * CPU tries its victims in; then comparing random and topology ordered
+ * stealing on a load all submitted into one queue.
+ *
+ */
+
+#include <cstdio>
+
+#include <random>
+#include <vector>
+
+#include "steal_harness.h"
+#include "topology.h"
+
+
+using std::vector;
+
+
+void print(Cpu_Topology const& topology) {
+    vector<unsigned> cpus;
+    for (Cpu_Topology::Cpu const& c : topology.cpus()) {
+        std::fprintf(stderr, "cpu%-3u package %d, core %d, l3 %d, node %d\n",
+                     c._cpu_, c._package_, c._core_, c._l3_, c._node_);
+        cpus.push_back(c._cpu_);
+    }
+    std::fprintf(stderr, "\n");
+
+    unsigned size = cpus.size();
+    Topology_Order order(size, cpus.data(), topology);
+    std::minstd_rand random;
+    vector<unsigned> victims(size);
+    for (unsigned i = 0; i < size; ++i) {
+        unsigned n = order.victims(random, i, size, victims.data());
+        std::fprintf(stderr, "cpu%-3u steals from", cpus[i]);
+        for (unsigned j = 0; j < n; ++j)
+            std::fprintf(stderr, " cpu%u", cpus[victims[j]]);
+        std::fprintf(stderr, "\n");
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    std::fprintf(stderr, "\nWait a moment...\n\n");
+
+    if (argc > 1)
+        print(Cpu_Topology(argv[1]));
+    else
+        print(Cpu_Topology::system());
+    std::fprintf(stderr, "\n");
+
+    Pool_Config config;
+    config._affinity_._mode_ = Affinity::MASK;
+    run_steal<Steal<Back_End, Front_End, Random_Order>>("random", "stream:16384", config);
+    run_steal<Steal<Back_End, Front_End, Topology_Order>>("topology", "stream:16384", config);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * variants_test.cpp
+ *
+ * Comparing submit throughput of every published Thread_Pool variant within
+ * one program.
+ *
+ */
+
+#include <cstdio>
+
+#include "blocking_overflow_blocking_unique_pool.h"
+#include "blocking_overflow_lockwise_mutual_pool.h"
+#include "blocking_shared_blocking_unique_pool.h"
+#include "blocking_shared_lockwise_mutual_2b_pool.h"
+#include "blocking_shared_lockwise_mutual_pool.h"
+#include "blocking_shared_pool.h"
+#include "blocking_unique_pool.h"
+#include "futex_unique_pool.h"
+#include "lockfree_mutual_pool.h"
+#include "lockfree_shared_pool.h"
+#include "lockwise_mutual_2a_pool.h"
+#include "lockwise_mutual_2b_pool.h"
+#include "lockwise_mutual_2c_pool.h"
+#include "lockwise_mutual_2d_pool.h"
+#include "lockwise_mutual_2e_pool.h"
+#include "lockwise_mutual_pool.h"
+#include "lockwise_shared_pool.h"
+#include "lockwise_unique_pool.h"
+#include "producers_harness.h"
+
+
+int main() {
+    std::fprintf(stderr, "\nReady...Go\n\nWait a moment...\n");
+    run_producers<Lockwise_Shared_Pool>("lockwise_shared");
+    run_producers<Lockfree_Shared_Pool>("lockfree_shared");
+    run_producers<Blocking_Shared_Pool>("blocking_shared");
+    run_producers<Lockwise_Unique_Pool<>>("lockwise_unique");
+    run_producers<Blocking_Unique_Pool<>>("blocking_unique");
+    run_producers<Futex_Unique_Pool<>>("futex_unique");
+    run_producers<Lockwise_Mutual_Pool<>>("lockwise_mutual");
+    run_producers<Lockwise_Mutual_2a_Pool<>>("lockwise_mutual_2a");
+    run_producers<Lockwise_Mutual_2b_Pool<>>("lockwise_mutual_2b");
+    run_producers<Lockwise_Mutual_2c_Pool<>>("lockwise_mutual_2c");
+    run_producers<Lockwise_Mutual_2d_Pool<>>("lockwise_mutual_2d");
+    run_producers<Lockwise_Mutual_2e_Pool<>>("lockwise_mutual_2e");
+    run_producers<Lockfree_Mutual_Pool<>>("lockfree_mutual");
+    run_producers<Blocking_Shared_Blocking_Unique_Pool<>>("blocking_shared_blocking_unique");
+    run_producers<Blocking_Shared_Lockwise_Mutual_Pool<>>("blocking_shared_lockwise_mutual");
+    run_producers<Blocking_Shared_Lockwise_Mutual_2b_Pool<>>("blocking_shared_lockwise_mutual_2b");
+    run_producers<Blocking_Overflow_Blocking_Unique_Pool<>>("blocking_overflow_blocking_unique");
+    run_producers<Blocking_Overflow_Lockwise_Mutual_Pool<>>("blocking_overflow_lockwise_mutual");
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}
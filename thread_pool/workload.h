@@ -0,0 +1,199 @@
+/*
+ * workload.h
+ *
+ * Synthetic task kernels for benchmarking Thread_Pool, which, unlike those
+ * of archery.h, touch no stdio lock.
+ *   - empty      does nothing at all
+ *   - spin:N     burns N nanoseconds of CPU in a loop calibrated once
+ *   - stream:N   reads and writes N bytes of a buffer of the thread's own,
+ *                bound by memory bandwidth once N outgrows the caches
+ *   - chase:N    follows N links of a random cycle through 16 MiB, a cache
+ *                miss at nearly every step
+ *   - sleep:N    blocks for N nanoseconds
+ *   - pareto:N   spins for a Pareto distributed time of mean N nanoseconds,
+ *                shape 1.5 and capped at 1000 N
+ *   - bimodal:N  spins for N nanoseconds, and for 100 N once in 100 tasks
+ *
+ * A Workload is a kernel and its N, parsed from strings like the above, and
+ * calling it runs the kernel.  It is trivially copyable, so a lambda
+ * capturing it stays inline in Task_Wrapper.
+ *
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "cache_line.h"
+
+
+inline uint64_t spin_loop(uint64_t iterations) {
+    uint64_t x = iterations;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        asm volatile("" : "+r"(x));
+    }
+    return x;
+}
+
+
+// measured once, by the first caller, over no less than 10 ms
+inline double spin_rate() {
+    static double const RATE = [] {
+        uint64_t iterations = 1 << 16;
+        for (;;) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            spin_loop(iterations);
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (ns >= 1e7)
+                return iterations / ns;
+            iterations *= 2;
+        }
+    }();
+    return RATE;
+}
+
+
+inline std::minstd_rand& workload_random() {
+    thread_local std::minstd_rand r(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return r;
+}
+
+
+struct alignas(CACHE_LINE_SIZE) Chase_Node {
+    Chase_Node* _next_;
+};
+
+
+constexpr size_t CHASE_SIZE = (16 << 20) / sizeof(Chase_Node);
+
+
+// all the nodes in one cycle of random order
+inline Chase_Node* chase_ring() {
+    static Chase_Node* const RING = [] {
+        Chase_Node* nodes = new Chase_Node[CHASE_SIZE];
+        std::vector<size_t> order(CHASE_SIZE);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::minstd_rand(CHASE_SIZE));
+        for (size_t i = 0; i < CHASE_SIZE; ++i)
+            nodes[order[i]]._next_ = &nodes[order[(i + 1) % CHASE_SIZE]];
+        return nodes;
+    }();
+    return RING;
+}
+
+
+inline void empty_kernel(uint64_t) {}
+
+
+inline void spin_kernel(uint64_t ns) {
+    spin_loop(static_cast<uint64_t>(ns * spin_rate()));
+}
+
+
+inline void stream_kernel(uint64_t bytes) {
+    thread_local std::vector<uint64_t> buffer;
+    size_t n = bytes / sizeof(uint64_t);
+    if (buffer.size() < n)
+        buffer.resize(n);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += buffer[i];
+        buffer[i] = sum;
+    }
+    asm volatile("" : : "r"(sum));
+}
+
+
+inline void chase_kernel(uint64_t steps) {
+    Chase_Node* node = chase_ring() + workload_random()() % CHASE_SIZE;
+    for (uint64_t i = 0; i < steps; ++i)
+        node = node->_next_;
+    asm volatile("" : : "r"(node));
+}
+
+
+inline void sleep_kernel(uint64_t ns) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+}
+
+
+// x_m = mean (a - 1) / a, by inverse transform sampling
+inline void pareto_kernel(uint64_t mean) {
+    double const SHAPE = 1.5;
+    double u = std::uniform_real_distribution<double>(0, 1)(workload_random());
+    double ns = mean * (SHAPE - 1) / SHAPE / std::pow(1 - u, 1 / SHAPE);
+    spin_kernel(static_cast<uint64_t>(std::min(ns, 1000.0 * mean)));
+}
+
+
+inline void bimodal_kernel(uint64_t ns) {
+    spin_kernel(workload_random()() % 100 ? ns : 100 * ns);
+}
+
+
+struct Workload {
+    void (*_kernel_)(uint64_t) = empty_kernel;
+    uint64_t _n_ = 0;
+
+    void operator()() const {
+        _kernel_(_n_);
+    }
+};
+
+
+struct Workload_Kernel {
+    char const* _name_;
+    void (*_kernel_)(uint64_t);
+    uint64_t _default_;
+};
+
+
+Workload_Kernel const WORKLOAD_KERNELS[] = {
+    {"empty", empty_kernel, 0},
+    {"spin", spin_kernel, 1000},
+    {"stream", stream_kernel, 1 << 20},
+    {"chase", chase_kernel, 1000},
+    {"sleep", sleep_kernel, 100000},
+    {"pareto", pareto_kernel, 1000},
+    {"bimodal", bimodal_kernel, 1000},
+};
+
+
+// "name" or "name:N", false for an unknown name
+inline bool parse_workload(char const* spec, Workload& workload) {
+    char const* colon = std::strchr(spec, ':');
+    size_t length = colon ? colon - spec : std::strlen(spec);
+    for (Workload_Kernel const& k : WORKLOAD_KERNELS) {
+        if (std::strlen(k._name_) == length && !std::strncmp(spec, k._name_, length)) {
+            workload._kernel_ = k._kernel_;
+            workload._n_ = colon ? std::strtoull(colon + 1, nullptr, 10) : k._default_;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// builds the shared state of the kernels before anything is timed
+inline void prepare_workload(Workload const& workload) {
+    spin_rate();
+    if (workload._kernel_ == chase_kernel)
+        chase_ring();
+}
+
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * workload_test.cpp
+ *
+ * Checking the kernels of workload.h on their own, i.e. how long each takes
+ * against what it is asked for.
+ *
+ */
+
+#include <cstdio>
+
+#include <chrono>
+
+#include "workload.h"
+
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::chrono::time_point;
+
+
+void run(char const* spec, unsigned times) {
+    Workload workload;
+    parse_workload(spec, workload);
+    prepare_workload(workload);
+    workload();
+    time_point<steady_clock> start = steady_clock::now();
+    for (unsigned i = 0; i < times; ++i)
+        workload();
+    double ns = duration<double, std::nano>(steady_clock::now() - start).count() / times;
+    std::fprintf(stderr, "[%-14s] %12.0f ns a task\n", spec, ns);
+}
+
+
+int main() {
+    std::fprintf(stderr, "\n%.3f spin iterations per ns\n\n", spin_rate());
+
+    run("empty", 1000000);
+    run("spin:100", 100000);
+    run("spin:1000", 10000);
+    run("spin:100000", 100);
+    run("stream:16384", 10000);
+    run("stream:67108864", 10);
+    run("chase:1000", 1000);
+    run("sleep:100000", 100);
+    run("pareto:1000", 10000);
+    run("bimodal:1000", 10000);
+
+    std::fprintf(stderr, "\nBye...\n");
+    return 0;
+}